@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "position.hpp"
+#include "search.hpp"
+#include "tt.hpp"
+
+namespace chess {
+
+struct AnnotateOptions {
+    SearchLimits limits;        // per position
+    bool reverse = false;       // analyze from the last position back
+    std::size_t hash_mb = 64;
+};
+
+// One played move, with both scores from White's point of view.
+struct PlyAnalysis {
+    Move played;
+    Move best;                  // engine's choice in the position before
+    int score_before = 0;       // best play from the position before
+    int score_after = 0;        // the position after the played move
+    int swing = 0;              // what the move cost its player (>= 0 is a loss)
+    int depth = 0;
+    uint64_t nodes = 0;
+};
+
+// Analyzes every position of a game with one searcher and hash table that
+// are kept from position to position: consecutive positions share most of
+// their tree, so later searches start from the earlier ones' results
+// (and killers/history) instead of from scratch.
+class Annotator {
+public:
+    using Progress = std::function<void(std::size_t done, std::size_t total)>;
+
+    explicit Annotator(const AnnotateOptions& opts = {});
+
+    std::vector<PlyAnalysis> analyze(const Position& start, const std::vector<Move>& moves,
+                                     const Progress& progress = {});
+
+    // "??" / "?" / "?!" by swing, "" for fine moves.
+    static std::string judgement(int swing);
+
+    // PGN annotation for one ply: NAG, score comment and, for mistakes,
+    // the engine's move as a variation numbered move_number.
+    static std::string pgn_comment(const Position& before, const PlyAnalysis& a, int move_number);
+
+    uint64_t nodes() const { return nodes_; }
+
+private:
+    AnnotateOptions opts_;
+    TranspositionTable tt_;
+    Searcher searcher_;
+    uint64_t nodes_ = 0;
+};
+
+} // namespace chess
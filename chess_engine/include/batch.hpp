@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include "search.hpp"
+
+namespace chess {
+
+struct BatchOptions {
+    SearchLimits limits;          // per position
+    int threads = 0;              // 0 = one per hardware thread
+    std::size_t hash_mb = 16;     // per worker
+    std::size_t window = 0;       // positions in flight; 0 = 8 per worker
+};
+
+// Offline analysis of an EPD/FEN stream. Every non-empty input line is one
+// job; workers each own a searcher and hash table and clear them between
+// positions, so a result never depends on which worker ran it. Output lines
+// come out in input order:
+//
+//   <fen 4 fields> acd <depth>; acn <nodes>; ce <cp>; bm <san>; pv <san...>; id "...";
+//
+// with "dm <n>" in place of ce for mate scores and c0 "<error>" for lines
+// that are not a position. At most `window` lines are held in memory.
+struct Batch {
+    // Returns the number of positions read.
+    static uint64_t analyze(std::istream& in, std::ostream& out, const BatchOptions& opts);
+
+    // One line, on the caller's searcher (tt is cleared first).
+    static std::string analyze_line(const std::string& line, Searcher& searcher,
+                                    TranspositionTable& tt, const SearchLimits& limits);
+};
+
+} // namespace chess
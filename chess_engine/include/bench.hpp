@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace chess {
+
+struct BenchResult {
+    uint64_t nodes = 0;     // signature: changes whenever the search does
+    int64_t time_ms = 0;
+    uint64_t nps = 0;
+    int positions = 0;
+};
+
+// Fixed-depth search over a built-in position set, single-threaded, with
+// the hash table and heuristics cleared before every position. The node
+// total depends only on the search code, so it doubles as a functional
+// signature: a change that should not alter the search must keep it.
+struct Bench {
+    static constexpr int DEFAULT_DEPTH = 6;
+
+    static const std::vector<std::string>& positions();
+
+    // Per-position lines go to log when given.
+    static BenchResult run(int depth = DEFAULT_DEPTH, std::size_t hash_mb = 16,
+                           std::ostream* log = nullptr);
+
+    // Summary block: nodes, time and nodes per second.
+    static void report(std::ostream& out, const BenchResult& r, int depth);
+};
+
+} // namespace chess
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "position.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+struct BookEntry {
+    Move move;
+    uint16_t weight = 0;
+};
+
+// Polyglot opening book (.bin): 16-byte big-endian records (key, move,
+// weight, learn) sorted by key. The file is memory-mapped and binary
+// searched in place, nothing is copied or parsed up front.
+class Book {
+public:
+    static constexpr std::size_t ENTRY_SIZE = 16;
+
+    bool open(const std::string& path, std::string& err);
+    void close() { file_.close(); }
+    bool is_open() const { return file_.is_open(); }
+    std::size_t size() const { return file_.size() / ENTRY_SIZE; }
+
+    // Legal book moves for the position, highest weight first.
+    std::vector<BookEntry> entries(const Position& pos) const;
+
+    // Weighted random choice among entries(); nullopt when out of book.
+    std::optional<Move> pick(const Position& pos, std::mt19937_64& rng) const;
+
+    // Polyglot position hash and move encoding (castling as king-takes-rook).
+    static uint64_t key(const Position& pos);
+    static uint16_t encode_move(const Position& pos, const Move& m);
+    static Move decode_move(const Position& pos, uint16_t pm);
+
+private:
+    MappedFile file_;
+};
+
+} // namespace chess
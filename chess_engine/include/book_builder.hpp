@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace chess {
+
+struct BookBuildOptions {
+    int max_ply = 30;          // only the first plies of each game go in
+    uint32_t min_count = 1;    // drop moves played fewer times than this
+    bool use_results = false;  // weight by 2*wins + draws instead of games
+    int threads = 0;           // 0 = one per hardware thread
+};
+
+struct BookBuildStats {
+    uint64_t games = 0;
+    uint64_t bad_games = 0;    // unparsable or illegal movetext
+    uint64_t moves = 0;        // (position, move) samples counted
+    uint64_t entries = 0;      // records written by the last write()
+};
+
+// Builds a Polyglot book from PGN. Games are parsed in parallel and their
+// (position key, move) counts aggregated in hash maps sharded by the top
+// bits of the key; each shard is thus a key range, so the output is sorted
+// by sorting shards independently and writing them in order.
+class BookBuilder {
+public:
+    explicit BookBuilder(const BookBuildOptions& opts = {});
+
+    // Memory-maps a PGN file and parses it on opts.threads threads.
+    bool add_pgn_file(const std::string& path, std::string& err);
+
+    // Same, for PGN text already in memory.
+    void add_pgn_text(std::string_view text);
+
+    bool write(const std::string& path, std::string& err);
+
+    BookBuildStats stats() const;
+
+private:
+    static constexpr int SHARD_BITS = 6;
+    static constexpr int SHARDS = 1 << SHARD_BITS;
+
+    struct EntryKey {
+        uint64_t key;
+        uint16_t move;
+        bool operator==(const EntryKey&) const = default;
+    };
+    struct EntryKeyHash {
+        std::size_t operator()(const EntryKey& k) const {
+            return (std::size_t)(k.key ^ (k.move * 0x9E3779B97F4A7C15ULL));
+        }
+    };
+    struct Counts {
+        uint32_t games = 0;
+        uint32_t points = 0;   // 2 per win, 1 per draw, for the side moving
+    };
+    struct Sample {
+        EntryKey k;
+        uint8_t points;
+    };
+    struct Shard {
+        std::mutex mu;
+        std::unordered_map<EntryKey, Counts, EntryKeyHash> map;
+    };
+
+    static int shard_of(uint64_t key) { return (int)(key >> (64 - SHARD_BITS)); }
+
+    void parse_chunk(std::string_view text, std::array<std::vector<Sample>, SHARDS>& pending);
+    void flush(int shard, std::vector<Sample>& pending);
+    int thread_count() const;
+
+    BookBuildOptions opts_;
+    std::array<Shard, SHARDS> shards_;
+    std::atomic<uint64_t> games_{0}, bad_games_{0}, moves_{0};
+    uint64_t entries_ = 0;
+};
+
+} // namespace chess
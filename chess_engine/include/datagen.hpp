@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "dataset.hpp"
+#include "search.hpp"
+
+namespace chess {
+
+struct DatagenOptions {
+    std::string output;            // dataset file (see dataset.hpp)
+    uint64_t games = 1000;         // upper bound on games played
+    uint64_t positions = 0;        // stop once this many are written; 0 = no limit
+    int threads = 0;               // games at once; 0 = one per hardware thread
+    uint64_t nodes = 5000;         // search budget per move
+    std::size_t hash_mb = 8;       // per thread
+    int random_plies = 8;          // random legal moves from the start position
+    int skip_plies = 8;            // plies after those before sampling starts
+    int max_plies = 400;           // longer games are adjudicated drawn
+    int win_score = 2500;          // |score| at which a game is adjudicated won...
+    int win_plies = 6;             // ...after this many plies in a row
+    std::size_t dedup_mb = 64;     // duplicate filter memory (see KeyFilter)
+    uint64_t seed = 0;             // 0 = random
+    SearchParams params;
+};
+
+// Fixed-memory filter of 64-bit position keys. Buckets of WAYS keys fill
+// one cache line; a key goes to the bucket picked by its low bits, and a
+// full bucket forgets its least recently seen key. Whole keys are stored,
+// so a new position is never dropped (short of a Zobrist collision or the
+// key 0, which reads as an empty way). A repeat gets through only once its
+// earlier copy was evicted: each bucket takes 1 / buckets of the new keys
+// and holds WAYS of them, so a key lasts about capacity() new keys. With
+// the default 64 MB (8M keys) a repeat is missed only if 8M or so other
+// positions were written since it was last seen, so positions that keep
+// recurring, like early opening ones, stay filtered however long the run.
+class KeyFilter {
+public:
+    static constexpr int WAYS = 8;
+
+    explicit KeyFilter(std::size_t bytes = std::size_t(64) << 20);
+
+    // true, and remembered, if key is not in the filter.
+    bool insert(uint64_t key);
+
+    std::size_t capacity() const { return buckets_.size() * WAYS; }
+
+private:
+    struct alignas(64) Bucket {
+        uint64_t keys[WAYS] = {};   // most recently seen first
+    };
+
+    std::vector<Bucket> buckets_;
+};
+
+struct DatagenStats {
+    uint64_t games = 0;
+    uint64_t positions = 0;        // written
+    uint64_t duplicates = 0;       // seen before, dropped
+    uint64_t white_wins = 0, draws = 0, black_wins = 0;
+};
+
+// Fixed-node self-play for evaluation training. Every thread plays its own
+// games; quiet positions (side to move not in check, best move neither a
+// capture nor a promotion, score not a mate) are kept with the search
+// score and, once the game ends, its result. A KeyFilter of dedup_mb drops
+// repeats; it is consulted under the writer's lock, where it costs one
+// cache line per sample and never allocates, so memory stays fixed however
+// long the run.
+class Datagen {
+public:
+    using Progress = std::function<void(const DatagenStats&)>;
+
+    explicit Datagen(const DatagenOptions& opts) : opts_(opts) {}
+
+    // Runs to completion or until stop() is called; progress is called
+    // after each game from the thread that played it (serialised).
+    bool run(std::string& err, const Progress& progress = {});
+    void stop() { stop_.store(true, std::memory_order_relaxed); }
+
+    const DatagenStats& stats() const { return stats_; }
+
+private:
+    struct Sample {
+        Position pos;
+        int score;
+    };
+
+    void worker(int index, DatasetWriter& out, std::mutex& mu, const Progress& progress);
+    int play_game(Searcher& searcher, TranspositionTable& tt, std::mt19937_64& rng,
+                  std::vector<Sample>& samples);
+
+    DatagenOptions opts_;
+    DatagenStats stats_;
+    KeyFilter seen_{0};   // sized by run()
+    std::atomic<uint64_t> games_started_{0};
+    std::atomic<bool> stop_{false};
+    bool write_failed_ = false;
+};
+
+} // namespace chess
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "packed.hpp"
+
+namespace chess {
+
+// One training sample. Byte-aligned and fixed-size, so a mapped dataset is
+// read in place.
+struct DataRecord {
+    PackedPosition pos;
+    uint8_t score_le[2] = {};   // search score, centipawns, White's view (clamped to 16 bits)
+    int8_t result = 0;          // game result for White: 1, 0 or -1
+    uint8_t reserved = 0;
+
+    int score() const { return (int16_t)(score_le[0] | (score_le[1] << 8)); }
+    void set_score(int cp) {
+        cp = cp < -32767 ? -32767 : cp > 32767 ? 32767 : cp;
+        score_le[0] = (uint8_t)cp;
+        score_le[1] = (uint8_t)((unsigned)cp >> 8);
+    }
+};
+
+static_assert(sizeof(DataRecord) == 36 && alignof(DataRecord) == 1);
+
+// Dataset file: a 16-byte header ("ICDS", version, record size) followed
+// by DataRecords back to back. The record count follows from the file size.
+class Dataset {
+public:
+    static constexpr std::size_t HEADER_SIZE = 16;
+
+    bool open(const std::string& path, std::string& err);
+    void close();
+
+    bool is_open() const { return file_.is_open(); }
+    std::size_t size() const { return records_.size(); }
+    const DataRecord& operator[](std::size_t i) const { return records_[i]; }
+
+    std::span<const DataRecord> records() const { return records_; }
+
+    // Contiguous part `index` of `count` (sizes differ by at most one), for
+    // giving each thread its own slice.
+    std::span<const DataRecord> shard(int index, int count) const;
+
+private:
+    MappedFile file_;
+    std::span<const DataRecord> records_;
+};
+
+// Streams records into a new dataset file.
+class DatasetWriter {
+public:
+    bool open(const std::string& path, std::string& err);
+    bool write(const DataRecord& r);
+
+    // score: White's view; result: 1, 0, -1 for White. false if the
+    // position does not pack (more than 32 pieces).
+    bool write(const Position& pos, int score, int result);
+
+    // One text sample: FEN or EPD, then an optional result token ("1-0",
+    // "0-1", "1/2-1/2") and EPD operations, of which "ce" (side to move's
+    // score) and "c9" (the quoted game result) are read. Score and result
+    // come back from White's view, 0 when absent. false if the position or
+    // a ce operand does not parse.
+    static bool parse_text(const std::string& line, Position& pos, int& score, int& result);
+
+    // Flushes; false if any write failed.
+    bool close(std::string& err);
+
+    uint64_t count() const { return count_; }
+
+private:
+    std::ofstream out_;
+    std::string path_;
+    uint64_t count_ = 0;
+};
+
+} // namespace chess
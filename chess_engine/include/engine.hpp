@@ -0,0 +1,90 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "position.hpp"
+#include "search.hpp"
+#include "tt.hpp"
+
+namespace chess {
+
+// Asynchronous, multi-threaded search front-end. go() returns immediately;
+// the search runs on a background thread (plus Threads-1 helper threads
+// sharing the hash table, "lazy SMP") until a limit is hit or stop() is
+// called, then reports through the done callback.
+class Engine {
+public:
+    using InfoCallback = Searcher::InfoCallback;
+    using DoneCallback = std::function<void(const SearchResult&)>;
+
+    Engine();
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // These wait for a running search to finish first.
+    void set_hash_mb(std::size_t mb);
+    void set_threads(int n);
+    void set_params(const SearchParams& p);
+    void new_game();
+
+    // Tables must outlive the engine; nullptr turns probing off.
+    void set_tablebase(const Tablebase* tb);
+
+    // Keys of the positions played before the next search root, oldest
+    // first, for repetition detection (see Searcher::set_game_history).
+    void set_game_history(const std::vector<uint64_t>& keys);
+
+    // Hash table snapshots (see TranspositionTable::save/load).
+    bool save_hash(const std::string& path, std::string& err);
+    bool load_hash(const std::string& path, std::string& err);
+
+    std::size_t hash_mb() const { return tt_.size_mb(); }
+    int threads() const { return (int)searchers_.size(); }
+    int hashfull() const { return tt_.hashfull(); }
+
+    void go(const Position& pos, const SearchLimits& limits,
+            InfoCallback on_info, DoneCallback on_done);
+    void stop();
+    void wait();
+
+    // Turn a running `limits.ponder` search into a normal timed search
+    // without restarting it. A ponder miss is just stop().
+    void ponderhit();
+    bool pondering() const { return pondering_.load(); }
+
+    bool searching() const { return searching_.load(); }
+
+    // Blocking convenience wrapper around go() + wait().
+    SearchResult search(const Position& pos, const SearchLimits& limits,
+                        InfoCallback on_info = InfoCallback{});
+
+private:
+    void run(Position pos, SearchLimits limits, InfoCallback on_info, DoneCallback on_done);
+    uint64_t total_nodes() const;
+
+    TranspositionTable tt_;
+    SearchParams params_;
+    const Tablebase* tb_ = nullptr;
+    std::vector<uint64_t> game_keys_;
+    std::vector<std::unique_ptr<Searcher>> searchers_;
+
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> searching_{false};
+    std::atomic<bool> pondering_{false};
+
+    // Lets an infinite or ponder search hold its bestmove until stop() or
+    // ponderhit() arrives.
+    std::mutex mu_;
+    std::condition_variable cv_;
+};
+
+} // namespace chess
@@ -1,10 +1,43 @@
-#pragma once
-#include "position.hpp"
-
-namespace chess {
-
-struct Eval {
-    static int evaluate(const Position& pos);
-};
-
-}
+#pragma once
+#include <array>
+#include <cstdint>
+#include "position.hpp"
+
+namespace chess {
+
+// Evaluation weights, White's view, as one flat table: material per piece
+// type (P N B R Q K), then a 64-square bonus table per type, indexed a1..h8
+// for White. Black pieces read the vertically mirrored square.
+struct EvalWeights {
+    static constexpr int MATERIAL = 0;
+    static constexpr int PST = 6;
+    static constexpr int COUNT = PST + 6 * 64;
+
+    static constexpr int pst_index(int type, int sq) { return PST + type * 64 + sq; }
+
+    std::array<int, COUNT> w{};
+};
+
+// One nonzero coefficient of the linear evaluation: the score is the sum
+// of weight[index] * coef over a position's features.
+struct EvalFeature {
+    uint16_t index;
+    int16_t coef;
+};
+
+struct Eval {
+    // Upper bound on the features of one position: material plus one
+    // table entry per square
+    static constexpr int MAX_FEATURES = 6 + 64;
+
+    static int evaluate(const Position& pos);
+    static int evaluate(const Position& pos, const EvalWeights& weights);
+
+    // The weights compiled in from eval_weights.inc
+    static const EvalWeights& weights();
+
+    // Coefficients of pos, merged by index, written to out; returns the count.
+    static int features(const Position& pos, EvalFeature* out);
+};
+
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <vector>
 #include "position.hpp"
 
 namespace chess {
@@ -7,6 +9,21 @@ class GameState {
 public:
     static bool is_checkmate(const Position& pos, Color who);
     static bool is_stalemate(const Position& pos, Color who);
+
+    // Neither side can ever mate: K v K, K+minor v K, or bishops on one colour.
+    static bool is_insufficient_material(const Position& pos);
+
+    // A hundred plies without a capture or pawn move; a mate delivered on
+    // the last of them still counts as mate.
+    static bool is_fifty_move_draw(const Position& pos);
+
+    // How often pos occurred earlier in the game. history holds the keys of
+    // the positions before pos, oldest first; only the last
+    // halfmove_clock() of them can match.
+    static int repetitions(const Position& pos, const std::vector<uint64_t>& history);
+    static bool is_threefold_repetition(const Position& pos, const std::vector<uint64_t>& history) {
+        return repetitions(pos, history) >= 2;
+    }
 };
 
 } // namespace chess
@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "pgn.hpp"
+#include "position.hpp"
+#include "search.hpp"
+
+namespace chess {
+
+struct EngineConfig {
+    std::string name = "Ichigo";
+    SearchParams params;
+    std::size_t hash_mb = 16;
+};
+
+// Per-move limits; base/inc run a real clock (a flag fall loses).
+struct TimeControl {
+    int64_t base_ms = 0;
+    int64_t inc_ms = 0;
+    int64_t movetime_ms = 0;
+    uint64_t nodes = 0;
+    int depth = 0;
+};
+
+struct SprtConfig {
+    bool enabled = false;
+    double elo0 = 0.0, elo1 = 5.0;     // H0: elo = elo0, H1: elo = elo1
+    double alpha = 0.05, beta = 0.05;  // error rates
+};
+
+struct MatchOptions {
+    EngineConfig a, b;
+    TimeControl tc;
+    int games = 100;            // upper bound; each opening is played with both colours
+    int concurrency = 0;        // games at once; 0 = one per hardware thread
+    std::string openings;       // EPD/FEN lines or PGN; empty = start position
+    uint64_t seed = 0;          // shuffles the openings when non-zero
+    int max_plies = 400;        // longer games are adjudicated drawn
+    SprtConfig sprt;
+    std::string pgn_path;       // finished games are appended here
+};
+
+// Wins, draws and losses from engine a's point of view.
+struct MatchScore {
+    int wins = 0, draws = 0, losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    double score() const;                  // 0..1
+    double elo() const;
+    double elo_error() const;              // 95% half-width
+};
+
+enum class SprtVerdict { None, AcceptH0, AcceptH1 };
+
+// Sequential probability ratio test on the logistic Elo model, with the
+// usual normal approximation of the game score (GSPRT).
+struct Sprt {
+    static double llr(const MatchScore& s, double elo0, double elo1);
+    static double lower_bound(double alpha, double beta);
+    static double upper_bound(double alpha, double beta);
+    static SprtVerdict verdict(const MatchScore& s, const SprtConfig& cfg);
+};
+
+struct Opening {
+    Position start = Position::startpos();
+    std::vector<Move> moves;
+    std::string fen;            // set when the opening is a FEN/EPD line
+};
+
+struct GameRecord {
+    PgnGame pgn;
+    int result = 0;             // +1 white won, 0 draw, -1 black won
+    std::string termination;
+    bool a_white = true;
+    bool aborted = false;       // stopped before the end; not scored
+};
+
+// Engine-vs-engine games in-process, one game per thread, each side with
+// its own searcher and hash table. Ends after opts.games games or as soon
+// as the SPRT reaches a verdict.
+class Match {
+public:
+    using Report = std::function<void(const MatchScore&, double llr, const GameRecord&)>;
+
+    explicit Match(const MatchOptions& opts);
+
+    bool run(std::string& err, const Report& on_game = {});
+
+    const MatchScore& score() const { return score_; }
+    double llr() const { return llr_; }
+    SprtVerdict verdict() const { return verdict_; }
+
+    static bool load_openings(const std::string& path, std::vector<Opening>& out, std::string& err);
+
+    static GameRecord play_game(const EngineConfig& white, const EngineConfig& black,
+                                const Opening& opening, const MatchOptions& opts,
+                                const std::atomic<bool>* stop = nullptr);
+
+private:
+    MatchOptions opts_;
+    MatchScore score_;
+    double llr_ = 0.0;
+    SprtVerdict verdict_ = SprtVerdict::None;
+};
+
+} // namespace chess
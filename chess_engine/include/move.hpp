@@ -15,6 +15,8 @@ struct Move {
     uint8_t from = 0;
     uint8_t to   = 0;
     uint8_t promo = PROMO_NONE; // promotion choice
+
+    bool operator==(const Move&) const = default;
 };
 
 } // namespace chess
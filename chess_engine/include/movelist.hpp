@@ -1,11 +1,23 @@
 #pragma once
-#include <array>
+#include <cstddef>
 #include "move.hpp"
 
 namespace chess {
 
+// Fixed-capacity move buffer. The storage is deliberately left
+// uninitialized: a list lives on every search frame and generator call, and
+// only the first `size` slots are ever read.
 struct MoveList {
-    std::array<Move, 256> moves{};
+    static constexpr int CAPACITY = 256;
+
+    struct Buffer {
+        Move& operator[](int i) { return reinterpret_cast<Move*>(raw)[i]; }
+        const Move& operator[](int i) const { return reinterpret_cast<const Move*>(raw)[i]; }
+
+        alignas(Move) unsigned char raw[CAPACITY * sizeof(Move)];
+    };
+
+    Buffer moves;
     int size = 0;
 
     void clear() { size = 0; }
@@ -13,4 +25,3 @@ struct MoveList {
 };
 
 } // namespace chess
-
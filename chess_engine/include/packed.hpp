@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include "position.hpp"
+
+namespace chess {
+
+// A position in 32 bytes, for datasets:
+//   [0, 8)    occupancy, bit sq set for every non-empty square (LE u64)
+//   [8, 24)   one 4-bit Piece code per occupied square in a1..h8 order,
+//             low nibble first (32 pieces at most)
+//   24        bit 0 side to move (1 = Black), bits 1-4 castling rights
+//   25        en passant square, 0xFF if none
+//   [26, 28)  halfmove clock (LE u16)
+//   [28, 30)  fullmove number (LE u16)
+//   [30, 32)  zero
+struct PackedPosition {
+    static constexpr int MAX_PIECES = 32;
+
+    uint8_t bytes[32] = {};
+
+    // false if pos has more than 32 pieces.
+    static bool pack(const Position& pos, PackedPosition& out);
+
+    // false on malformed data (bad piece code, ep square or flags).
+    bool unpack(Position& out) const;
+
+    bool operator==(const PackedPosition& o) const;
+};
+
+static_assert(sizeof(PackedPosition) == 32);
+
+} // namespace chess
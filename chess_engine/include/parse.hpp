@@ -1,10 +1,36 @@
 #pragma once
 #include <string>
 #include <optional>
+#include <string_view>
+#include <vector>
 #include "types.hpp"
+#include "move.hpp"
+#include "position.hpp"
 
 namespace chess {
 
+// Why Parse::fen rejected its input
+enum class FenError : uint8_t {
+    None,
+    MissingField,     // no board or no side to move
+    Board,            // bad piece letter, rank length or number of ranks
+    Kings,            // not exactly one king per side
+    PawnOnBackRank,
+    SideToMove,
+    Castling,         // bad letter, repeated right, or king/rook not at home
+    EnPassant,        // not a square behind a pawn that just double-pushed
+    HalfmoveClock,
+    FullmoveNumber,
+    TrailingInput,
+};
+
+struct FenStatus {
+    FenError error = FenError::None;
+    int offset = 0;   // byte offset of the offending field
+
+    explicit operator bool() const { return error == FenError::None; }
+};
+
 class Parse {
 public:
     // "e2" -> square index (0=a1 .. 63=h8). returns nullopt if invalid.
@@ -13,6 +39,29 @@ public:
     // "e2 e4" -> {from,to}. Ignores leading/trailing spaces.
     // returns nullopt if invalid format.
     static std::optional<std::pair<int,int>> two_squares(const std::string& line);
+
+    // UCI long algebraic: "e2e4", "e7e8q". Castling is the king move ("e1g1").
+    static std::optional<Move> uci_move(const std::string& s);
+
+    // Standard algebraic notation ("Nf3", "exd5", "O-O", "e8=Q+"), resolved
+    // against the legal moves of pos. returns nullopt if illegal or ambiguous.
+    static std::optional<Move> san(const Position& pos, std::string_view s);
+
+    // Full FEN: board, side to move, castling rights, ep square, halfmove
+    // clock and fullmove number. Castling, ep and the clocks may be left off
+    // as in EPD; missing clocks read as "0 1". Works in place on the view,
+    // without allocating. On failure out is unspecified.
+    static FenStatus fen(std::string_view fen, Position& out);
+
+    // Same, nullopt if invalid.
+    static std::optional<Position> fen(std::string_view fen);
+
+    // Short description of a FenError ("bad castling rights")
+    static const char* fen_error(FenError e);
+
+    // EPD operations after the position fields: "opcode operands;" pieces
+    // split on ';' outside quoted strings, trimmed, empty ones dropped.
+    static std::vector<std::string> epd_operations(std::string_view text);
 };
 
 } // namespace chess
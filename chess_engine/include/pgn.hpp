@@ -0,0 +1,47 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "position.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+struct PgnGame {
+    std::vector<std::pair<std::string, std::string>> tags;
+    Position start = Position::startpos();   // from the FEN tag, if any
+    std::vector<Move> moves;                 // main line only
+    std::string result = "*";                // "1-0", "0-1", "1/2-1/2" or "*"
+
+    // Value of a tag pair, "" if absent
+    std::string tag(const std::string& name) const;
+};
+
+// Called for every main-line move with the position before it is played.
+using PgnMoveVisitor = std::function<void(const Position&, const Move&)>;
+
+class Pgn {
+public:
+    // Splits a PGN buffer into games (tag pairs + movetext). No copies: the
+    // views point into text.
+    static std::vector<std::string_view> split_games(std::string_view text);
+
+    // Offset of the first "[Event" line at or after from (text.size() if
+    // none). Used to cut a large file into chunks on game boundaries.
+    static std::size_t next_game_start(std::string_view text, std::size_t from);
+
+    // Parses one game. Comments, variations and NAGs are skipped; SAN moves
+    // are resolved against the legal move list. Parsing stops after
+    // max_plies moves when it is non-zero.
+    static bool parse_game(std::string_view text, PgnGame& out, std::string& err,
+                           int max_plies = 0, const PgnMoveVisitor& on_move = {});
+
+    // PGN text for a game: tag pairs, then SAN movetext wrapped at 80
+    // columns. annotations[i], when given and non-empty, is written after
+    // move i as is (NAGs, {comments}, (variations)).
+    static std::string write(const PgnGame& game, const std::vector<std::string>& annotations = {});
+};
+
+} // namespace chess
@@ -3,6 +3,7 @@
 #include <string>
 #include "types.hpp"
 #include "move.hpp"
+#include "zobrist.hpp"
 
 namespace chess {
 
@@ -20,19 +21,51 @@ public:
     static Position startpos();
 
     Piece at(int sq) const { return board_[sq]; }
-    void set(int sq, Piece p) { board_[sq] = p; }
+
+    // The squares alone, for scratch copies that don't need the key.
+    const std::array<Piece, 64>& board() const { return board_; }
+    void set(int sq, Piece p) {
+        key_ ^= Zobrist::piece(board_[sq], sq) ^ Zobrist::piece(p, sq);
+        board_[sq] = p;
+    }
 
     Color side_to_move() const { return stm_; }
-    void set_side_to_move(Color c) { stm_ = c; }
+    void set_side_to_move(Color c) {
+        if (c != stm_) key_ ^= Zobrist::side();
+        stm_ = c;
+    }
 
     bool make_move(const Move& m, std::string& err);
 
+    // Pass the turn without moving (search-only "null move"). Nothing
+    // before a pass can repeat after it, so the clock restarts.
+    void make_null_move() { set_side_to_move(other(stm_)); set_ep_square(-1); halfmove_ = 0; }
+
+    // Plies since the last capture or pawn move: the fifty-move counter and
+    // how far back a repetition can possibly reach. Not part of key().
+    int halfmove_clock() const { return halfmove_; }
+    void set_halfmove_clock(int n) { halfmove_ = (uint16_t)n; }
+
+    // FEN move number: starts at 1, incremented after each Black move.
+    int fullmove_number() const { return fullmove_; }
+    void set_fullmove_number(int n) { fullmove_ = (uint16_t)n; }
+
     uint8_t castling_rights() const { return cr_; }
-    void set_castling_rights(uint8_t cr) { cr_ = cr; }
+    void set_castling_rights(uint8_t cr) {
+        key_ ^= Zobrist::castling(cr_) ^ Zobrist::castling(cr);
+        cr_ = cr;
+    }
     
     int ep_square() const { return ep_; }          // -1 if none
-    void set_ep_square(int sq) { ep_ = sq; }       // set to -1 to clear
+    void set_ep_square(int sq) {                   // set to -1 to clear
+        if (ep_ != -1) key_ ^= Zobrist::ep_file(file_of(ep_));
+        if (sq != -1)  key_ ^= Zobrist::ep_file(file_of(sq));
+        ep_ = sq;
+    }
 
+    // Zobrist hash of board, side to move, castling rights and ep square.
+    // Maintained incrementally by every setter.
+    uint64_t key() const { return key_; }
 
 
 private:
@@ -40,6 +73,9 @@ private:
     Color stm_ = Color::White;
     uint8_t cr_ = CR_NONE;
     int ep_ = -1;  // en passant target square (the square "passed over"), or -1
+    uint16_t halfmove_ = 0;
+    uint16_t fullmove_ = 1;
+    uint64_t key_ = 0;
 };
 
 } // namespace chess
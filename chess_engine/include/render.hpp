@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <string>
 #include "position.hpp"
 
@@ -11,6 +12,21 @@ public:
 
     // single character for piece (KQBNRP / kqbnrp / '.')
     static char piece_char(Piece p);
+
+    // UCI long algebraic ("e2e4", "e7e8q")
+    static std::string move_uci(const Move& m);
+
+    // Longest FEN (with clocks) plus the terminating NUL
+    static constexpr std::size_t FEN_MAX = 96;
+
+    // Six-field FEN of pos, written NUL-terminated to buf (at least FEN_MAX
+    // bytes). Returns the length. Parse::fen reads it back unchanged.
+    static std::size_t fen(const Position& pos, char* buf);
+    static std::string fen(const Position& pos);
+
+    // Standard algebraic notation ("Nbd2", "exd6", "O-O", "e8=Q#") for a
+    // legal move in pos.
+    static std::string move_san(const Position& pos, const Move& m);
 };
 
 } // namespace chess
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <string>
 #include "position.hpp"
 #include "move.hpp"
@@ -15,8 +16,24 @@ public:
     static bool is_castle_move(const Position& pos, const Move& m);
     static bool castle_path_safe(const Position& pos, const Move& m, std::string& err);
 
+    // Colour-templated forms; the overloads taking a Color dispatch here.
+    template <Color By>  static bool is_square_attacked(const Position& pos, int sq);
+    template <Color Who> static bool in_check(const Position& pos);
+
+    // Square of the cheapest piece of `by` attacking sq (pawn, knight,
+    // bishop, rook, queen, king), or -1. Pins are ignored. Sliders are seen
+    // through the current board only, so removing a piece that was in the
+    // way reveals the x-ray attacker behind it on the next call. Takes a
+    // bare board so exchange evaluation can play on a cheap copy.
+    static int smallest_attacker(const std::array<Piece, 64>& board, int sq, Color by);
+    template <Color By> static int smallest_attacker(const std::array<Piece, 64>& board, int sq);
+    static int smallest_attacker(const Position& pos, int sq, Color by) {
+        return smallest_attacker(pos.board(), sq, by);
+    }
+
 private:
-    static bool pseudo_pawn(const Position& pos, Piece p, const Move& m, std::string& err);
+    template <Color Us> static bool castle_path_safe_for(const Position& pos, const Move& m, std::string& err);
+    template <Color Us> static bool pseudo_pawn(const Position& pos, const Move& m, std::string& err);
     static bool pseudo_knight(const Position& pos, Piece p, int from, int to, std::string& err);
     static bool pseudo_bishop(const Position& pos, Piece p, int from, int to, std::string& err);
     static bool pseudo_rook  (const Position& pos, Piece p, int from, int to, std::string& err);
@@ -28,7 +45,7 @@ private:
     static bool is_opponent(Piece moving, Piece target);
     static bool is_friend(Piece moving, Piece target);
 
-    static int  find_king(const Position& pos, Color who);
+    template <Color Who> static int find_king(const Position& pos);
     static bool has_right(uint8_t rights, uint8_t flag) { return (rights & flag) != 0; }
 };
 
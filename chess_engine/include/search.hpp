@@ -1,16 +1,261 @@
-#pragma once
-#include "position.hpp"
-#include "move.hpp"
-
-namespace chess {
-
-struct SearchResult {
-    Move best;
-    int score;
-};
-
-struct Search {
-    static SearchResult minimax(Position& pos, int depth);
-};
-
-}
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "position.hpp"
+#include "movelist.hpp"
+#include "move.hpp"
+#include "tt.hpp"
+#include "tablebase.hpp"
+
+namespace chess {
+
+constexpr int MATE_SCORE = 100000;
+constexpr int MAX_PLY    = 128;
+
+inline bool is_mate_score(int s) { return s >= MATE_SCORE - MAX_PLY || s <= -(MATE_SCORE - MAX_PLY); }
+
+// Search statistics are collected only when built with ICHIGO_SEARCH_STATS
+// (CMake option, on by default). Otherwise every counter update compiles
+// away and the stats in a SearchResult stay empty.
+#ifndef ICHIGO_SEARCH_STATS
+#define ICHIGO_SEARCH_STATS 0
+#endif
+
+struct IterationStats {
+    int depth = 0;
+    int seldepth = 0;
+    uint64_t nodes = 0;     // this iteration only, quiescence included
+    uint64_t qnodes = 0;
+    int64_t time_ms = 0;
+};
+
+// Counters of one search thread. Engine adds the helper threads' counters
+// to the main thread's.
+struct SearchStats {
+    static constexpr bool enabled = ICHIGO_SEARCH_STATS != 0;
+
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;
+    uint64_t beta_cutoffs = 0;
+    uint64_t first_move_cutoffs = 0;    // cutoffs by the first move searched
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;
+    uint64_t tt_cutoffs = 0;
+    int seldepth = 0;
+    std::vector<IterationStats> iterations;
+
+    double first_move_cutoff_rate() const { return beta_cutoffs ? double(first_move_cutoffs) / beta_cutoffs : 0.0; }
+    double tt_hit_rate() const { return tt_probes ? double(tt_hits) / tt_probes : 0.0; }
+
+    // Geometric mean growth of the node count from one iteration to the next
+    double branching_factor() const;
+
+    // Adds another thread's counters (iterations are kept from this one).
+    void merge(const SearchStats& other);
+};
+
+// One root move's line in a MultiPV search
+struct PvLine {
+    int score = 0;          // White's point of view
+    std::vector<Move> pv;
+};
+
+struct SearchResult {
+    Move best;
+    int score;              // from White's point of view, like Eval::evaluate
+    int depth = 0;          // last completed iteration
+    std::vector<Move> pv;   // principal variation, pv[0] == best
+    std::vector<PvLine> lines;  // best first, limits.multipv of them; lines[0] is pv
+    uint64_t nodes = 0;
+    SearchStats stats;      // empty unless SearchStats::enabled
+};
+
+// Tunable search constants. Margins are in centipawns.
+struct SearchParams {
+    int aspiration_window  = 50;   // half-width of the first root window
+
+    int null_min_depth     = 3;    // null move only from this depth
+    int null_r_base        = 2;    // R = base + depth / div
+    int null_r_div         = 4;
+
+    int lmr_min_depth      = 3;    // late move reductions from this depth
+    int lmr_min_move       = 3;    // ... and from this move number
+
+    int rfp_max_depth      = 6;    // reverse futility: eval - margin*depth >= beta
+    int rfp_margin         = 90;
+
+    int futility_max_depth = 2;    // skip quiets when eval + margin <= alpha
+    int futility_base      = 100;  // margin = base + per_depth * depth
+    int futility_per_depth = 150;
+
+    int razor_max_depth    = 2;    // drop into quiescence when eval + margin*depth < alpha
+    int razor_margin       = 300;
+
+    int lmp_max_depth      = 3;    // skip quiets after base + depth^2 moves
+    int lmp_base           = 3;
+
+    // Fields by name, for match configurations and tuners.
+    using Field = std::pair<const char*, int SearchParams::*>;
+    static const std::vector<Field>& fields();
+
+    // false if there is no such field
+    bool set(const std::string& name, int value);
+};
+
+// All limits are optional; zero means "not set". With nothing set the
+// search runs until MAX_PLY or until stopped.
+struct SearchLimits {
+    int depth = 0;
+    uint64_t nodes = 0;
+    int64_t movetime_ms = 0;            // fixed time for this move
+    int64_t wtime_ms = 0, btime_ms = 0; // remaining clock time
+    int64_t winc_ms = 0, binc_ms = 0;
+    int movestogo = 0;
+    bool infinite = false;              // ignore clocks, run until stopped
+    bool ponder = false;                // search the expected reply; clocks start at ponderhit
+    int multipv = 1;                    // root moves to report, each with its own line
+};
+
+// Progress report. After a completed iteration `pv` holds the line; the
+// periodic updates sent while an iteration is running leave it empty.
+struct SearchInfo {
+    int depth = 0;
+    int seldepth = 0;
+    int score = 0;          // White's point of view
+    uint64_t nodes = 0;
+    int64_t time_ms = 0;
+    std::vector<Move> pv;
+    int multipv = 1;        // rank of this line, 1 = best
+};
+
+// One search thread's worth of state: PV table, move-ordering heuristics
+// and counters. The transposition table is shared by reference so several
+// Searchers can run on the same position (see Engine).
+class Searcher {
+public:
+    using InfoCallback = std::function<void(const SearchInfo&)>;
+
+    explicit Searcher(TranspositionTable& tt, const SearchParams& params = SearchParams{});
+
+    void set_params(const SearchParams& p) { params_ = p; }
+    const SearchParams& params() const { return params_; }
+
+    // Optional external stop request (UCI "stop"), polled during search.
+    void set_stop_flag(const std::atomic<bool>* stop) { external_stop_ = stop; }
+
+    // Optional flag that stays true while a `limits.ponder` search is still
+    // pondering. When it drops (ponder hit) the search keeps its tree and
+    // starts honoring the clock limits from that moment on.
+    void set_ponder_flag(const std::atomic<bool>* pondering) { ponder_flag_ = pondering; }
+
+    // Optional endgame tables; covered positions below the root are scored
+    // exactly instead of searched.
+    void set_tablebase(const Tablebase* tb) { tb_ = tb; }
+
+    // Keys of the game positions before the root, oldest first. Positions
+    // in the tree that repeat one of them, or an earlier node on the
+    // current line, are scored as draws.
+    void set_game_history(std::vector<uint64_t> keys) { game_keys_ = std::move(keys); }
+
+    // Callers sharing a table bump tt.new_search() once per root search.
+    SearchResult search(const Position& pos, const SearchLimits& limits,
+                        const InfoCallback& on_info = InfoCallback{});
+
+    uint64_t nodes() const { return nodes_.load(std::memory_order_relaxed); }
+
+    // Statistics of the last (or running) search on this thread.
+    const SearchStats& stats() const { return stats_; }
+    void reset_nodes() { nodes_.store(0, std::memory_order_relaxed); }
+
+    // Forget killers and history (new game).
+    void clear();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    int alphabeta(Position& pos, int depth, int ply, int alpha, int beta, bool allow_null);
+    bool is_repetition(const Position& pos, int ply) const;
+    int quiescence(Position& pos, int ply, int alpha, int beta);
+
+    void score_moves(const Position& pos, const MoveList& moves, int ply, const Move& tt_move,
+                     std::array<int, MoveList::CAPACITY>& scores);
+    void update_quiet_stats(const Move& m, int ply, int depth);
+
+    void start_clock(const Position& pos, const SearchLimits& limits);
+    int64_t elapsed_ms() const;
+    int64_t clock_ms() const;
+    bool pondering();
+    void poll();
+
+    TranspositionTable& tt_;
+    SearchParams params_;
+    const std::atomic<bool>* external_stop_ = nullptr;
+    const std::atomic<bool>* ponder_flag_ = nullptr;
+    const Tablebase* tb_ = nullptr;
+
+    // Triangular PV table: pv_[ply] holds the line found below `ply`.
+    std::array<std::array<Move, MAX_PLY>, MAX_PLY> pv_;
+    std::array<int, MAX_PLY> pv_len_{};
+
+    // Line from the previous iteration, tried first while we are still on it.
+    std::vector<Move> prev_pv_;
+    bool follow_pv_ = false;
+
+    // MultiPV: root moves already reported at this depth, skipped by the
+    // passes that look for the next best line.
+    std::vector<Move> root_excluded_;
+
+    // Scratch space for each ply, allocated once per thread and never
+    // zeroed: the move list, its ordering scores, and the child position
+    // that copy-make plays moves into (our undo record).
+    struct alignas(64) Frame {
+        MoveList moves;
+        std::array<int, MoveList::CAPACITY> scores;
+        Position child;
+    };
+    std::unique_ptr<Frame[]> stack_;
+
+    // Game history followed by the keys along the current line: the node
+    // at `ply` is path_[root_ + ply].
+    std::vector<uint64_t> game_keys_;
+    std::vector<uint64_t> path_;
+    int root_ = 0;
+
+    std::array<std::array<Move, 2>, MAX_PLY> killers_{};
+    std::array<std::array<int, 64>, 64> history_{};
+
+    std::atomic<uint64_t> nodes_{0};
+    int seldepth_ = 0;
+    SearchStats stats_;
+    bool stopped_ = false;
+
+    Clock::time_point start_;        // search start, for reporting
+    Clock::time_point clock_start_;  // when time limits started to count
+    bool pondering_ = false;
+    int64_t soft_ms_ = 0;   // don't start another iteration after this
+    int64_t hard_ms_ = 0;   // abort the running iteration after this
+    uint64_t node_limit_ = 0;
+    int64_t last_report_ms_ = 0;
+    const InfoCallback* on_info_ = nullptr;
+};
+
+struct Search {
+    // Iterative deepening PVS up to `depth` plies, with aspiration windows
+    // around the previous iteration's score.
+    // Without a table of its own the caller gets a small per-thread one,
+    // cleared on every call so results do not depend on earlier searches.
+    static SearchResult minimax(Position& pos, int depth);
+    static SearchResult minimax(Position& pos, int depth, const SearchParams& params);
+    // Searches with the caller's table, keeping what earlier calls stored.
+    static SearchResult minimax(Position& pos, int depth, const SearchParams& params,
+                                TranspositionTable& tt);
+};
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "position.hpp"
+#include "move.hpp"
+
+namespace chess {
+
+// Static exchange evaluation: the material outcome of a capture sequence on
+// one square when both sides always recapture with their cheapest piece
+// and may stop whenever continuing would lose. X-ray attackers behind
+// sliders join in as the pieces in front of them are traded off. Pins and
+// checks are not considered.
+struct See {
+    // Net gain in centipawns for the side making move m. Works for quiet
+    // moves too: negative when the moved piece can be won.
+    static int value(const Position& pos, const Move& m);
+
+    // value(pos, m) >= threshold
+    static bool ge(const Position& pos, const Move& m, int threshold) { return value(pos, m) >= threshold; }
+
+    static int piece_value(Piece p);
+};
+
+} // namespace chess
@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+#include "match.hpp"
+#include "search.hpp"
+
+namespace chess {
+
+// One tunable SearchParams field. c_end and r_end are the perturbation
+// size and learning rate reached on the last iteration (as in fishtest);
+// the schedules are scaled up from them.
+struct SpsaParam {
+    std::string name;
+    double value = 0.0;
+    double min = 0.0, max = 0.0;
+    double c_end = 1.0;
+    double r_end = 0.002;
+};
+
+struct SpsaOptions {
+    MatchOptions match;              // time control, openings, concurrency, hash, max plies
+    int iterations = 1000;           // game pairs
+    double alpha = 0.602, gamma = 0.101;
+    double a_ratio = 0.1;            // stability constant A = a_ratio * iterations
+    std::string checkpoint;          // resume from / save to; empty = none
+    int checkpoint_every = 16;       // iterations between saves
+    uint64_t seed = 0;               // 0 = random
+};
+
+// Simultaneous perturbation stochastic approximation over engine games.
+// Each iteration flips a random sign per parameter, plays a pair of games
+// (same opening, colours swapped) between theta + c_k * delta and
+// theta - c_k * delta, and moves theta by a_k / c_k * result * delta, where
+// result is the pair's score for the plus side (-2..2). Iterations run on
+// several threads at once against the latest theta; parameters are
+// rounded for play and clamped to their range.
+class Spsa {
+public:
+    // After every finished iteration, serialised
+    using Progress = std::function<void(int iteration, const std::vector<SpsaParam>&)>;
+
+    Spsa(const SpsaOptions& opts, std::vector<SpsaParam> params);
+
+    // A declared set of the pruning margins and reductions worth tuning
+    static std::vector<SpsaParam> default_params();
+
+    // Plays until opts.iterations are done, resuming from the checkpoint
+    // if it exists, and saves it periodically and at the end.
+    bool run(std::string& err, const Progress& progress = {});
+    void stop() { stop_.store(true, std::memory_order_relaxed); }
+
+    bool save(const std::string& path, std::string& err) const;
+    bool load(const std::string& path, std::string& err);
+
+    int iteration() const { return iteration_; }
+    const std::vector<SpsaParam>& params() const { return params_; }
+
+    // theta as SearchParams (rounded)
+    SearchParams current() const;
+
+    // Schedules at iteration k (0-based) for parameter i
+    double c_k(int i, int k) const;
+    double a_k(int i, int k) const;
+
+    // theta += a_k / c_k * result * delta, clamped
+    void update(int k, const std::vector<int>& delta, double result);
+
+private:
+    SearchParams with_offsets(const std::vector<double>& theta, const std::vector<int>& delta,
+                              int k, int sign) const;
+    void worker(const std::vector<Opening>& openings, uint64_t seed, const Progress& progress,
+                std::string& err);
+
+    SpsaOptions opts_;
+    std::vector<SpsaParam> params_;
+    int iteration_ = 0;      // completed
+    int next_ = 0;           // handed out
+    std::mutex mu_;
+    std::atomic<bool> stop_{false};
+};
+
+} // namespace chess
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+#include "mapped_file.hpp"
+#include "position.hpp"
+
+namespace chess {
+
+enum class Wdl : int8_t { Loss = -1, Draw = 0, Win = 1 };
+
+// Side to move's view: dtm is the number of plies to mate (0 for draws
+// and for a side that is already mated).
+struct TbResult {
+    Wdl wdl = Wdl::Draw;
+    int dtm = 0;
+};
+
+// Piece slots of a table: white king, black king, then the white and black
+// pieces in name order. pawns fixes the board's orientation.
+struct TbLayout {
+    std::vector<Piece> pieces;
+    bool pawns = false;
+    std::size_t size = 0;   // entries, both sides to move
+};
+
+// Endgame tables for up to four pieces, one byte per position (distance
+// to mate, which also gives win/draw/loss). Tables are named by material
+// with the stronger side first ("KQvK", "KRPvK", "KQvKR") and stored as
+// <dir>/<name>.itb; positions with the colours reversed are probed by
+// mirroring the board.
+//
+// Tables know nothing about castling or en passant rights: positions that
+// still have either are not probed.
+class Tablebase {
+public:
+    static constexpr int MAX_PIECES = 4;
+
+    // Maps every table found in dir. Missing dir or no tables is not an error.
+    bool load_dir(const std::string& dir, std::string& err);
+    void clear();
+
+    bool has(const std::string& name) const;
+    std::size_t count() const { return tables_.size(); }
+    int max_pieces() const { return max_pieces_; }
+
+    // nullopt when the material is not covered.
+    std::optional<TbResult> probe(const Position& pos) const;
+
+    // Retrograde generation; tables the ending converts into (captures,
+    // promotions) are generated first when not already present. threads = 0
+    // uses every core.
+    bool generate(const std::string& name, std::string& err, int threads = 0);
+
+    // Writes a generated (or mapped) table to <dir>/<name>.itb.
+    bool save(const std::string& name, const std::string& dir, std::string& err) const;
+
+    // Canonical table name for the material on the board ("KRvK"), weaker
+    // side's pieces after the 'v'. Empty if a side has no king.
+    static std::string material_name(const Position& pos);
+
+    // Every table with at most n pieces, smallest first.
+    static std::vector<std::string> all_names(int n);
+
+private:
+    struct Table {
+        TbLayout layout;
+        std::vector<uint8_t> memory;   // generated in this process
+        MappedFile file;               // or loaded from disk
+        const uint8_t* data = nullptr;
+        std::size_t size = 0;
+    };
+
+    std::map<std::string, Table> tables_;
+    int max_pieces_ = 0;
+};
+
+} // namespace chess
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "move.hpp"
+
+namespace chess {
+
+enum Bound : uint8_t {
+    BOUND_NONE  = 0,
+    BOUND_UPPER = 1, // failed low: score is an upper bound
+    BOUND_LOWER = 2, // failed high: score is a lower bound
+    BOUND_EXACT = 3,
+};
+
+struct TTEntry {
+    Move move;
+    int score = 0;
+    int depth = 0;
+    Bound bound = BOUND_NONE;
+};
+
+// Shared, lockless transposition table. Each slot stores (key ^ data, data)
+// so a torn write from another thread just reads back as a miss.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(std::size_t mb = 16);
+
+    void resize(std::size_t mb);
+    void clear();
+    void new_search() { gen_ = (uint8_t)((gen_ + 1) & 63); }
+
+    bool probe(uint64_t key, TTEntry& out) const;
+    void store(uint64_t key, const Move& m, int score, int depth, Bound bound);
+
+    // Snapshots for warm starts. The file holds a 32-byte header ("ICTT",
+    // version, slot count, Zobrist fingerprint, checksum) and the raw slots.
+    // load() checks all of it, then copies the entries in, rehashing them if
+    // the table size differs. Don't call either during a search.
+    bool save(const std::string& path, std::string& err) const;
+    bool load(const std::string& path, std::string& err);
+
+    std::size_t size_mb() const { return mb_; }
+    int hashfull() const; // permille of slots used by the current search
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t count_ = 0;
+    std::size_t mb_ = 0;
+    uint8_t gen_ = 0;
+
+    Slot& slot(uint64_t key) const { return slots_[key & (count_ - 1)]; }
+};
+
+} // namespace chess
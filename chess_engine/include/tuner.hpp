@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <vector>
+#include "dataset.hpp"
+#include "eval.hpp"
+
+namespace chess {
+
+struct TunerOptions {
+    int threads = 0;          // 0 = one per hardware thread
+    double k = 0.0;           // sigmoid scale; 0 = fit to the data first
+    double lambda = 1.0;      // target = lambda * result + (1 - lambda) * sigmoid(score)
+    double learning_rate = 1.0;
+};
+
+// Texel tuning of EvalWeights. Every position's evaluation is linear in the
+// weights, so its coefficients are extracted once (Eval::features) into one
+// sparse array; each epoch then costs one pass over it. The error is the
+// mean squared difference between the target and
+//   sigmoid(eval) = 1 / (1 + 10^(-k * eval / 400))
+// and the weights follow its gradient (Adam), computed over contiguous
+// slices of the positions on every core.
+class Tuner {
+public:
+    using Progress = std::function<void(int epoch, double error)>;
+
+    explicit Tuner(const TunerOptions& opts = TunerOptions{});
+
+    // Extracts coefficients and targets, in parallel. Records that do not
+    // unpack are skipped. Returns the number of positions added.
+    std::size_t load(const Dataset& ds);
+
+    // One position: result in [0, 1] for White, score White's view
+    void add(const Position& pos, double result, int score = 0);
+
+    std::size_t size() const { return labels_.size(); }
+
+    // Picks the k that minimises the error of the current weights.
+    double fit_k();
+    double k() const { return k_; }
+
+    double error() const;
+    void train(int epochs, const Progress& progress = {});
+
+    const std::vector<double>& raw_weights() const { return w_; }
+    EvalWeights weights() const;   // rounded
+
+    // The weights in eval_weights.inc layout, ready to compile into Eval.
+    static void write_weights(std::ostream& out, const EvalWeights& w);
+
+private:
+    struct Label {
+        float result;
+        float score;
+    };
+
+    double sigmoid(double eval) const;
+    double target(const Label& l) const;
+    int nthreads() const;
+
+    // Parallel reduction over position slices; fn(begin, end, grad) adds
+    // into grad (which may be null) and returns the summed squared error.
+    double reduce(const std::function<double(std::size_t, std::size_t, double*)>& fn,
+                  std::vector<double>* grad) const;
+
+    TunerOptions opts_;
+    double k_;
+    std::vector<double> w_;
+
+    // Position i owns features_[offsets_[i], offsets_[i + 1])
+    std::vector<EvalFeature> features_;
+    std::vector<uint64_t> offsets_{0};
+    std::vector<Label> labels_;
+
+    // Adam state
+    std::vector<double> m_, v_;
+    int step_ = 0;
+};
+
+} // namespace chess
@@ -20,6 +20,32 @@ inline bool is_empty(Piece p) { return p == Piece::Empty; }
 inline bool is_white(Piece p) { return p >= Piece::WP && p <= Piece::WK; }
 inline bool is_black(Piece p) { return p >= Piece::BP && p <= Piece::BK; }
 
+// Compile-time constants for code templated on a side, so colour tests
+// become constants instead of branches in inner loops.
+template <Color C> struct ColorTraits;
+
+template <> struct ColorTraits<Color::White> {
+    static constexpr Color them = Color::Black;
+    static constexpr int forward = +1;      // pawn direction in ranks
+    static constexpr int start_rank = 1;    // pawn double-step rank
+    static constexpr int last_rank = 7;     // promotion rank
+    static constexpr int back_rank = 0;     // king and rooks start here
+    static constexpr Piece pawn = Piece::WP, knight = Piece::WN, bishop = Piece::WB,
+                           rook = Piece::WR, queen = Piece::WQ, king = Piece::WK;
+    static bool owns(Piece p) { return p >= Piece::WP && p <= Piece::WK; }
+};
+
+template <> struct ColorTraits<Color::Black> {
+    static constexpr Color them = Color::White;
+    static constexpr int forward = -1;
+    static constexpr int start_rank = 6;
+    static constexpr int last_rank = 0;
+    static constexpr int back_rank = 7;
+    static constexpr Piece pawn = Piece::BP, knight = Piece::BN, bishop = Piece::BB,
+                           rook = Piece::BR, queen = Piece::BQ, king = Piece::BK;
+    static bool owns(Piece p) { return p >= Piece::BP; }
+};
+
 // Square indexing: 0 = a1, 7 = h1, 56 = a8, 63 = h8
 inline int file_of(int sq) { return sq & 7; }        // 0..7
 inline int rank_of(int sq) { return sq >> 3; }       // 0..7
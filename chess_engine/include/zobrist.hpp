@@ -0,0 +1,49 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "types.hpp"
+
+namespace chess {
+
+// Zobrist keys for position hashing. Empty squares, White to move, no
+// castling rights and no en passant square all hash to zero, so a
+// default-constructed Position has key 0.
+struct Zobrist {
+    static uint64_t piece(Piece p, int sq) { return keys().psq[static_cast<int>(p)][sq]; }
+    static uint64_t side()                 { return keys().side; }
+    static uint64_t castling(uint8_t cr)   { return keys().castling[cr & 15]; }
+    static uint64_t ep_file(int file)      { return keys().ep[file]; }
+
+private:
+    struct Keys {
+        std::array<std::array<uint64_t, 64>, 13> psq{};
+        std::array<uint64_t, 16> castling{};
+        std::array<uint64_t, 8> ep{};
+        uint64_t side = 0;
+    };
+
+    static constexpr uint64_t splitmix64(uint64_t& s) {
+        uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr Keys make_keys() {
+        Keys k;
+        uint64_t s = 0x1C41D4F0ULL;
+        for (int p = 1; p < 13; ++p)
+            for (int sq = 0; sq < 64; ++sq) k.psq[p][sq] = splitmix64(s);
+        for (int cr = 1; cr < 16; ++cr) k.castling[cr] = splitmix64(s);
+        for (int f = 0; f < 8; ++f) k.ep[f] = splitmix64(s);
+        k.side = splitmix64(s);
+        return k;
+    }
+
+    static const Keys& keys() {
+        static constexpr Keys k = make_keys();
+        return k;
+    }
+};
+
+} // namespace chess
@@ -0,0 +1,74 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "batch.hpp"
+
+// Batch analysis of an EPD/FEN file, one result line per position:
+//   ichigo_analyze [--depth N | --movetime MS | --nodes N] [--threads N]
+//                  [--hash MB] [-o out.epd] positions.epd
+
+static void usage() {
+    std::cerr << "usage: ichigo_analyze [options] positions.epd|-\n"
+                 "  --depth N      search depth per position (default 8)\n"
+                 "  --movetime MS  time per position instead of depth\n"
+                 "  --nodes N      node budget per position instead of depth\n"
+                 "  --threads N    worker threads (default: all cores)\n"
+                 "  --hash MB      hash table per worker (default 16)\n"
+                 "  -o FILE        output file (default: stdout)\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    BatchOptions opts;
+    std::string in_path, out_path;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--depth" && i + 1 < argc)         opts.limits.depth = std::stoi(argv[++i]);
+            else if (a == "--movetime" && i + 1 < argc) opts.limits.movetime_ms = std::stoll(argv[++i]);
+            else if (a == "--nodes" && i + 1 < argc)    opts.limits.nodes = std::stoull(argv[++i]);
+            else if (a == "--threads" && i + 1 < argc)  opts.threads = std::stoi(argv[++i]);
+            else if (a == "--hash" && i + 1 < argc)     opts.hash_mb = (std::size_t)std::max(1, std::stoi(argv[++i]));
+            else if (a == "-o" && i + 1 < argc)         out_path = argv[++i];
+            else if (a == "-h" || a == "--help")        { usage(); return 0; }
+            else if (a.size() > 1 && a[0] == '-')       { usage(); return 1; }
+            else in_path = a;
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    if (in_path.empty()) {
+        usage();
+        return 1;
+    }
+    if (opts.limits.depth == 0 && opts.limits.movetime_ms == 0 && opts.limits.nodes == 0) {
+        opts.limits.depth = 8;
+    }
+
+    std::ifstream fin;
+    if (in_path != "-") {
+        fin.open(in_path);
+        if (!fin) {
+            std::cerr << "Cannot open " << in_path << "\n";
+            return 1;
+        }
+    }
+    std::ofstream fout;
+    if (!out_path.empty()) {
+        fout.open(out_path);
+        if (!fout) {
+            std::cerr << "Cannot write " << out_path << "\n";
+            return 1;
+        }
+    }
+
+    std::istream& in = (in_path == "-") ? std::cin : fin;
+    std::ostream& out = out_path.empty() ? std::cout : fout;
+    uint64_t n = Batch::analyze(in, out, opts);
+    std::cerr << "Analyzed " << n << " positions\n";
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include "annotate.hpp"
+#include "render.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+namespace chess {
+
+namespace {
+
+// Swing thresholds in centipawns
+constexpr int BLUNDER    = 300;
+constexpr int MISTAKE    = 100;
+constexpr int INACCURACY = 50;
+
+// Mate scores count as a large but finite advantage for swings
+int clamp_score(int s) {
+    return std::clamp(s, -2000, 2000);
+}
+
+std::string score_text(int white_score) {
+    std::ostringstream out;
+    if (is_mate_score(white_score)) {
+        int plies = MATE_SCORE - std::abs(white_score);
+        out << (white_score > 0 ? "#" : "#-");
+        if (plies > 0) out << (plies + 1) / 2;   // bare "#": mate on the board
+    } else {
+        out << (white_score >= 0 ? "+" : "-") << std::abs(white_score) / 100 << "."
+            << (std::abs(white_score) % 100 < 10 ? "0" : "") << std::abs(white_score) % 100;
+    }
+    return out.str();
+}
+
+} // namespace
+
+Annotator::Annotator(const AnnotateOptions& opts)
+    : opts_(opts), tt_(opts.hash_mb), searcher_(tt_) {}
+
+std::vector<PlyAnalysis> Annotator::analyze(const Position& start, const std::vector<Move>& moves,
+                                            const Progress& progress) {
+    // Positions 0..n; n is the one after the last move
+    std::vector<Position> positions{start};
+    std::string err;
+    for (const Move& m : moves) {
+        Position next = positions.back();
+        if (!next.make_move(m, err)) break;
+        positions.push_back(next);
+    }
+
+    const std::size_t n = positions.size();
+    std::vector<SearchResult> results(n);
+    nodes_ = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        std::size_t i = opts_.reverse ? n - 1 - k : k;
+        tt_.new_search();
+        std::vector<uint64_t> history;   // game so far, for repetitions
+        for (std::size_t j = 0; j < i; ++j) history.push_back(positions[j].key());
+        searcher_.set_game_history(std::move(history));
+        results[i] = searcher_.search(positions[i], opts_.limits);
+        nodes_ += results[i].nodes;
+        if (progress) progress(k + 1, n);
+    }
+
+    std::vector<PlyAnalysis> out;
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        PlyAnalysis a;
+        a.played = moves[i];
+        a.best = results[i].best;
+        a.score_before = results[i].score;
+        a.score_after = results[i + 1].score;
+        a.depth = results[i].depth;
+        a.nodes = results[i].nodes;
+
+        int loss = clamp_score(a.score_before) - clamp_score(a.score_after);
+        a.swing = (positions[i].side_to_move() == Color::White) ? loss : -loss;
+        if (a.played == a.best) a.swing = std::min(a.swing, 0);
+        out.push_back(a);
+    }
+    return out;
+}
+
+std::string Annotator::judgement(int swing) {
+    if (swing >= BLUNDER) return "??";
+    if (swing >= MISTAKE) return "?";
+    if (swing >= INACCURACY) return "?!";
+    return "";
+}
+
+std::string Annotator::pgn_comment(const Position& before, const PlyAnalysis& a, int move_number) {
+    static const char* NAGS[] = {"$4", "$2", "$6"};   // ??, ?, ?!
+    std::string j = judgement(a.swing);
+    std::ostringstream out;
+    if (j == "??") out << NAGS[0] << " ";
+    else if (j == "?") out << NAGS[1] << " ";
+    else if (j == "?!") out << NAGS[2] << " ";
+
+    out << "{" << score_text(a.score_after) << "/" << a.depth << "}";
+
+    if (!j.empty() && !(a.best == Move{})) {
+        out << " (" << move_number << (before.side_to_move() == Color::White ? "." : "...") << " "
+            << Render::move_san(before, a.best) << " {" << score_text(a.score_before) << "})";
+    }
+    return out.str();
+}
+
+} // namespace chess
@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "annotate.hpp"
+#include "mapped_file.hpp"
+#include "parse.hpp"
+#include "pgn.hpp"
+#include "render.hpp"
+
+// Annotates whole games, keeping the hash table between positions:
+//   ichigo_annotate [--depth N | --movetime MS | --nodes N] [--reverse]
+//                   [--hash MB] [--table] games.pgn
+//   ichigo_annotate [options] [--fen FEN] --moves "e4 e5 Nf3 ..."
+
+static void usage() {
+    std::cerr << "usage: ichigo_annotate [options] games.pgn | [--fen FEN] --moves \"...\"\n"
+                 "  --depth N      search depth per position (default 10)\n"
+                 "  --movetime MS  time per position instead of depth\n"
+                 "  --nodes N      node budget per position instead of depth\n"
+                 "  --reverse      analyze from the final position backwards\n"
+                 "  --hash MB      hash table size (default 64)\n"
+                 "  --table        print a per-move table instead of annotated PGN\n";
+}
+
+// Moves in SAN or UCI notation
+static bool parse_moves(const chess::Position& start, const std::string& text,
+                        std::vector<chess::Move>& out, std::string& err) {
+    using namespace chess;
+    Position pos = start;
+    std::istringstream in(text);
+    for (std::string tok; in >> tok;) {
+        std::optional<Move> m = Parse::san(pos, tok);
+        if (!m) m = Parse::uci_move(tok);
+        if (!m || !pos.make_move(*m, err)) {
+            err = "Illegal move: " + tok;
+            return false;
+        }
+        out.push_back(*m);
+    }
+    return true;
+}
+
+static void print_table(const chess::PgnGame& game, const std::vector<chess::PlyAnalysis>& plies) {
+    using namespace chess;
+    Position pos = game.start;
+    std::string err;
+    std::cout << "ply  move      score   best      best-score  swing\n";
+    for (std::size_t i = 0; i < plies.size(); ++i) {
+        const PlyAnalysis& a = plies[i];
+        std::string played = Render::move_san(pos, a.played) + Annotator::judgement(a.swing);
+        std::string best = (a.best == Move{}) ? "-" : Render::move_san(pos, a.best);
+        std::printf("%-4zu %-9s %6d   %-9s %10d  %5d\n", i + 1, played.c_str(), a.score_after,
+                    best.c_str(), a.score_before, a.swing);
+        pos.make_move(a.played, err);
+    }
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    AnnotateOptions opts;
+    std::string pgn_path, fen, moves_text;
+    bool table = false, have_moves = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--depth" && i + 1 < argc)         opts.limits.depth = std::stoi(argv[++i]);
+            else if (a == "--movetime" && i + 1 < argc) opts.limits.movetime_ms = std::stoll(argv[++i]);
+            else if (a == "--nodes" && i + 1 < argc)    opts.limits.nodes = std::stoull(argv[++i]);
+            else if (a == "--hash" && i + 1 < argc)     opts.hash_mb = (std::size_t)std::max(1, std::stoi(argv[++i]));
+            else if (a == "--fen" && i + 1 < argc)      fen = argv[++i];
+            else if (a == "--moves" && i + 1 < argc)    { moves_text = argv[++i]; have_moves = true; }
+            else if (a == "--reverse")                  opts.reverse = true;
+            else if (a == "--table")                    table = true;
+            else if (a == "-h" || a == "--help")        { usage(); return 0; }
+            else if (a.size() > 1 && a[0] == '-')       { usage(); return 1; }
+            else pgn_path = a;
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    if (pgn_path.empty() == !have_moves) {
+        usage();
+        return 1;
+    }
+    if (opts.limits.depth == 0 && opts.limits.movetime_ms == 0 && opts.limits.nodes == 0) {
+        opts.limits.depth = 10;
+    }
+
+    std::vector<PgnGame> games;
+    std::string err;
+    if (have_moves) {
+        PgnGame g;
+        if (!fen.empty()) {
+            auto p = Parse::fen(fen);
+            if (!p) {
+                std::cerr << "Invalid FEN\n";
+                return 1;
+            }
+            g.start = *p;
+            g.tags.push_back({"SetUp", "1"});
+            g.tags.push_back({"FEN", fen});
+        }
+        if (!parse_moves(g.start, moves_text, g.moves, err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        games.push_back(std::move(g));
+    } else {
+        MappedFile file;
+        if (!file.open(pgn_path, err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+        for (std::string_view g : Pgn::split_games(text)) {
+            PgnGame game;
+            if (!Pgn::parse_game(g, game, err)) {
+                std::cerr << "Skipping game: " << err << "\n";
+                continue;
+            }
+            games.push_back(std::move(game));
+        }
+    }
+
+    Annotator annotator(opts);
+    for (const PgnGame& game : games) {
+        auto plies = annotator.analyze(game.start, game.moves, [](std::size_t done, std::size_t total) {
+            std::cerr << "\r" << done << "/" << total << " positions" << std::flush;
+        });
+        std::cerr << "  (" << annotator.nodes() << " nodes)\n";
+
+        if (table) {
+            print_table(game, plies);
+            continue;
+        }
+
+        std::vector<std::string> notes;
+        Position pos = game.start;
+        int number = 1;
+        for (const PlyAnalysis& a : plies) {
+            notes.push_back(Annotator::pgn_comment(pos, a, number));
+            if (pos.side_to_move() == Color::Black) ++number;
+            pos.make_move(a.played, err);
+        }
+
+        PgnGame out = game;
+        out.tags.push_back({"Annotator", "Ichigo"});
+        std::cout << Pgn::write(out, notes) << "\n";
+    }
+    return 0;
+}
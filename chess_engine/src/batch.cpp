@@ -0,0 +1,161 @@
+#include "batch.hpp"
+#include "parse.hpp"
+#include "render.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace chess {
+
+std::string Batch::analyze_line(const std::string& line, Searcher& searcher,
+                                TranspositionTable& tt, const SearchLimits& limits) {
+    // Four FEN fields, then either the two move clocks (a full FEN) or EPD
+    // operations. The clocks matter: the halfmove clock drives the
+    // fifty-move rule in the search.
+    std::istringstream in(line);
+    std::string f[6];
+    int nf = 0;
+    while (nf < 6 && in >> f[nf]) ++nf;
+    const std::string fen4 = f[0] + " " + f[1] + " " + f[2] + " " + f[3];
+
+    Position pos;
+    int used = 4;
+    bool valid = nf >= 4;
+    if (valid && nf == 6 && Parse::fen(fen4 + " " + f[4] + " " + f[5], pos)) used = 6;
+    else valid = valid && Parse::fen(fen4, pos);
+
+    std::string rest;
+    for (int i = used; i < nf; ++i) rest += f[i] + " ";
+    std::string tail;
+    std::getline(in, tail);
+    rest += tail;
+
+    std::string id;
+    for (const std::string& op : Parse::epd_operations(rest)) {
+        if (op == "id" || op.rfind("id ", 0) == 0) id = op;
+    }
+
+    std::ostringstream out;
+    if (!valid) {
+        out << line << " c0 \"invalid position\";";
+        return out.str();
+    }
+
+    tt.clear();
+    tt.new_search();
+    searcher.clear();
+    SearchResult res = searcher.search(pos, limits);
+
+    out << fen4 << " acd " << res.depth << "; acn " << res.nodes << ";";
+
+    int s = (pos.side_to_move() == Color::White) ? res.score : -res.score;
+    if (is_mate_score(s)) {
+        int plies = MATE_SCORE - std::abs(s);
+        out << " dm " << ((s > 0) ? (plies + 1) / 2 : -(plies / 2)) << ";";
+    } else {
+        out << " ce " << s << ";";
+    }
+
+    if (!(res.best == Move{})) {
+        out << " bm " << Render::move_san(pos, res.best) << ";";
+        Position p = pos;
+        std::string err;
+        out << " pv";
+        for (const Move& m : res.pv) {
+            out << " " << Render::move_san(p, m);
+            if (!p.make_move(m, err)) break;
+        }
+        out << ";";
+    }
+    if (!id.empty()) out << " " << id << ";";
+    return out.str();
+}
+
+uint64_t Batch::analyze(std::istream& in, std::ostream& out, const BatchOptions& opts) {
+    const int nthreads = opts.threads > 0 ? opts.threads
+                                          : std::max(1, (int)std::thread::hardware_concurrency());
+    const std::size_t window = opts.window > 0 ? opts.window : (std::size_t)nthreads * 8;
+
+    // The reader may run at most `window` lines ahead of the writer, which
+    // bounds both the job queue and the reorder buffer.
+    std::mutex mu;
+    std::condition_variable cv;
+    std::deque<std::pair<uint64_t, std::string>> jobs;
+    std::map<uint64_t, std::string> done;
+    uint64_t read = 0, written = 0;
+    bool eof = false;
+
+    auto worker = [&]() {
+        TranspositionTable tt(opts.hash_mb);
+        Searcher searcher(tt);
+        for (;;) {
+            std::pair<uint64_t, std::string> job;
+            {
+                std::unique_lock<std::mutex> lock(mu);
+                cv.wait(lock, [&] { return !jobs.empty() || eof; });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            std::string result = analyze_line(job.second, searcher, tt, opts.limits);
+            {
+                std::lock_guard<std::mutex> lock(mu);
+                done.emplace(job.first, std::move(result));
+            }
+            cv.notify_all();
+        }
+    };
+
+    auto writer = [&]() {
+        std::unique_lock<std::mutex> lock(mu);
+        for (;;) {
+            cv.wait(lock, [&] { return done.count(written) || (eof && written == read); });
+            if (eof && written == read) return;
+            std::string line = std::move(done[written]);
+            done.erase(written);
+            lock.unlock();
+            out << line << "\n";
+            lock.lock();
+            ++written;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < nthreads; ++t) pool.emplace_back(worker);
+    std::thread out_thread(writer);
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos) continue;
+
+        std::unique_lock<std::mutex> lock(mu);
+        cv.wait(lock, [&] { return read - written < window; });
+        jobs.emplace_back(read++, std::move(line));
+        lock.unlock();
+        cv.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mu);
+        eof = true;
+    }
+    cv.notify_all();
+
+    for (auto& t : pool) t.join();
+    out_thread.join();
+    out.flush();
+    return read;
+}
+
+} // namespace chess
@@ -0,0 +1,25 @@
+#include <iostream>
+#include <string>
+
+#include "bench.hpp"
+
+// Search speed and functional signature:
+//   ichigo_bench [depth] [hash MB]
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    int depth = Bench::DEFAULT_DEPTH;
+    std::size_t hash_mb = 16;
+    try {
+        if (argc > 1) depth = std::max(1, std::stoi(argv[1]));
+        if (argc > 2) hash_mb = (std::size_t)std::max(1, std::stoi(argv[2]));
+    } catch (...) {
+        std::cerr << "usage: ichigo_bench [depth] [hash MB]\n";
+        return 1;
+    }
+
+    BenchResult r = Bench::run(depth, hash_mb, &std::cerr);
+    Bench::report(std::cout, r, depth);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "book.hpp"
+#include "movegen.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace chess {
+
+// Polyglot hashes a position as the XOR of 781 random keys:
+//   [0, 768)   piece on square: 64 * kind + 8 * rank + file, where kind is
+//              black pawn 0, white pawn 1, black knight 2, ... white king 11
+//   [768, 772) castling rights: white O-O, white O-O-O, black O-O, black O-O-O
+//   [772, 780) en passant file, only when a pawn can actually capture there
+//   780        white to move
+// The keys are the published table, so keys match books from other tools.
+static constexpr uint64_t RANDOM64[781] = {
+#include "polyglot_random.inc"
+};
+
+static constexpr int RANDOM_CASTLE = 768;
+static constexpr int RANDOM_EP     = 772;
+static constexpr int RANDOM_TURN   = 780;
+
+static uint64_t read_be(const unsigned char* p, int bytes) {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+// Polyglot piece kind: (type * 2) + (white ? 1 : 0), pawn=0 .. king=5
+static int polyglot_kind(Piece p) {
+    int code = static_cast<int>(p);     // WP..WK = 1..6, BP..BK = 7..12
+    int type = (code - 1) % 6;
+    return type * 2 + (is_white(p) ? 1 : 0);
+}
+
+uint64_t Book::key(const Position& pos) {
+    const uint64_t* r = RANDOM64;
+    uint64_t k = 0;
+
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p)) continue;
+        k ^= r[64 * polyglot_kind(p) + 8 * rank_of(sq) + file_of(sq)];
+    }
+
+    uint8_t cr = pos.castling_rights();
+    if (cr & CR_WK) k ^= r[RANDOM_CASTLE + 0];
+    if (cr & CR_WQ) k ^= r[RANDOM_CASTLE + 1];
+    if (cr & CR_BK) k ^= r[RANDOM_CASTLE + 2];
+    if (cr & CR_BQ) k ^= r[RANDOM_CASTLE + 3];
+
+    // En passant only counts if a pawn of the side to move stands next to
+    // the double-pushed pawn
+    int ep = pos.ep_square();
+    if (ep != -1) {
+        bool white = (pos.side_to_move() == Color::White);
+        Piece our_pawn = white ? Piece::WP : Piece::BP;
+        int r_from = white ? 4 : 3;
+        int f = file_of(ep);
+        bool capturable = (f > 0 && pos.at(make_sq(f - 1, r_from)) == our_pawn) ||
+                          (f < 7 && pos.at(make_sq(f + 1, r_from)) == our_pawn);
+        if (capturable) k ^= r[RANDOM_EP + f];
+    }
+
+    if (pos.side_to_move() == Color::White) k ^= r[RANDOM_TURN];
+    return k;
+}
+
+// to_file:3 | to_row:3 | from_file:3 | from_row:3 | promo:3 (n=1 b=2 r=3 q=4)
+uint16_t Book::encode_move(const Position& pos, const Move& m) {
+    int to = m.to;
+
+    Piece p = pos.at(m.from);
+    if ((p == Piece::WK || p == Piece::BK) && rank_of(m.from) == rank_of(m.to) &&
+        std::abs(file_of(m.to) - file_of(m.from)) == 2) {
+        to = make_sq(file_of(m.to) > file_of(m.from) ? 7 : 0, rank_of(m.to));
+    }
+
+    int promo = 0;
+    switch (m.promo) {
+        case PROMO_N: promo = 1; break;
+        case PROMO_B: promo = 2; break;
+        case PROMO_R: promo = 3; break;
+        case PROMO_Q: promo = 4; break;
+        default: break;
+    }
+
+    return (uint16_t)(file_of(to) | (rank_of(to) << 3) |
+                      (file_of(m.from) << 6) | (rank_of(m.from) << 9) | (promo << 12));
+}
+
+Move Book::decode_move(const Position& pos, uint16_t pm) {
+    Move m;
+    m.to   = (uint8_t)make_sq(pm & 7, (pm >> 3) & 7);
+    m.from = (uint8_t)make_sq((pm >> 6) & 7, (pm >> 9) & 7);
+
+    switch ((pm >> 12) & 7) {
+        case 1: m.promo = PROMO_N; break;
+        case 2: m.promo = PROMO_B; break;
+        case 3: m.promo = PROMO_R; break;
+        case 4: m.promo = PROMO_Q; break;
+        default: break;
+    }
+
+    // King "captures" its own rook: e1h1 -> e1g1, e1a1 -> e1c1
+    Piece p = pos.at(m.from);
+    if ((p == Piece::WK || p == Piece::BK) && file_of(m.from) == 4 && rank_of(m.from) == rank_of(m.to)) {
+        if (file_of(m.to) == 7) m.to = (uint8_t)make_sq(6, rank_of(m.to));
+        else if (file_of(m.to) == 0) m.to = (uint8_t)make_sq(2, rank_of(m.to));
+    }
+    return m;
+}
+
+bool Book::open(const std::string& path, std::string& err) {
+    if (!file_.open(path, err)) return false;
+    if (file_.size() % ENTRY_SIZE != 0) {
+        err = "Not a Polyglot book (size is not a multiple of 16): " + path;
+        file_.close();
+        return false;
+    }
+    return true;
+}
+
+std::vector<BookEntry> Book::entries(const Position& pos) const {
+    std::vector<BookEntry> out;
+    if (!is_open()) return out;
+
+    const unsigned char* base = file_.data();
+    const uint64_t k = key(pos);
+
+    // Lower bound on the key, straight from the mapping
+    std::size_t lo = 0, hi = size();
+    while (lo < hi) {
+        std::size_t mid = lo + (hi - lo) / 2;
+        if (read_be(base + mid * ENTRY_SIZE, 8) < k) lo = mid + 1;
+        else hi = mid;
+    }
+
+    MoveList legal;
+    MoveGen::generate_legal(pos, legal);
+
+    for (std::size_t i = lo; i < size(); ++i) {
+        const unsigned char* e = base + i * ENTRY_SIZE;
+        if (read_be(e, 8) != k) break;
+
+        BookEntry be;
+        be.move   = decode_move(pos, (uint16_t)read_be(e + 8, 2));
+        be.weight = (uint16_t)read_be(e + 10, 2);
+
+        // Skip stale entries from hash collisions or broken books
+        bool ok = false;
+        for (int j = 0; j < legal.size && !ok; ++j) ok = (legal.moves[j] == be.move);
+        if (ok) out.push_back(be);
+    }
+
+    std::stable_sort(out.begin(), out.end(),
+                     [](const BookEntry& a, const BookEntry& b) { return a.weight > b.weight; });
+    return out;
+}
+
+std::optional<Move> Book::pick(const Position& pos, std::mt19937_64& rng) const {
+    std::vector<BookEntry> es = entries(pos);
+    if (es.empty()) return std::nullopt;
+
+    uint64_t total = 0;
+    for (const auto& e : es) total += e.weight;
+    if (total == 0) {
+        std::uniform_int_distribution<std::size_t> pick(0, es.size() - 1);
+        return es[pick(rng)].move;
+    }
+
+    std::uniform_int_distribution<uint64_t> dist(0, total - 1);
+    uint64_t x = dist(rng);
+    for (const auto& e : es) {
+        if (x < e.weight) return e.move;
+        x -= e.weight;
+    }
+    return es.front().move;
+}
+
+} // namespace chess
@@ -0,0 +1,182 @@
+#include "book_builder.hpp"
+#include "book.hpp"
+#include "mapped_file.hpp"
+#include "pgn.hpp"
+#include <algorithm>
+#include <fstream>
+#include <thread>
+
+namespace chess {
+
+// Samples are handed to the shared shards in batches to keep locking rare
+static constexpr std::size_t FLUSH_AT = 4096;
+
+BookBuilder::BookBuilder(const BookBuildOptions& opts) : opts_(opts) {}
+
+int BookBuilder::thread_count() const {
+    if (opts_.threads > 0) return opts_.threads;
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+void BookBuilder::flush(int shard, std::vector<Sample>& pending) {
+    if (pending.empty()) return;
+    Shard& s = shards_[shard];
+    std::lock_guard<std::mutex> lock(s.mu);
+    for (const Sample& smp : pending) {
+        Counts& c = s.map[smp.k];
+        ++c.games;
+        c.points += smp.points;
+    }
+    pending.clear();
+}
+
+void BookBuilder::parse_chunk(std::string_view text, std::array<std::vector<Sample>, SHARDS>& pending) {
+    PgnGame game;
+    std::string err;
+    std::vector<std::pair<EntryKey, bool>> line;   // bool: white moved
+
+    for (std::string_view g : Pgn::split_games(text)) {
+        line.clear();
+        bool ok = Pgn::parse_game(g, game, err, opts_.max_ply,
+            [&line](const Position& pos, const Move& m) {
+                line.push_back({{Book::key(pos), Book::encode_move(pos, m)},
+                                pos.side_to_move() == Color::White});
+            });
+        if (!ok) {
+            bad_games_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        games_.fetch_add(1, std::memory_order_relaxed);
+        moves_.fetch_add(line.size(), std::memory_order_relaxed);
+
+        uint8_t white_pts = 1, black_pts = 1;
+        if (game.result == "1-0") { white_pts = 2; black_pts = 0; }
+        else if (game.result == "0-1") { white_pts = 0; black_pts = 2; }
+        else if (game.result == "*") { white_pts = black_pts = 0; }
+
+        for (const auto& [k, white] : line) {
+            int sh = shard_of(k.key);
+            pending[sh].push_back({k, white ? white_pts : black_pts});
+            if (pending[sh].size() >= FLUSH_AT) flush(sh, pending[sh]);
+        }
+    }
+}
+
+void BookBuilder::add_pgn_text(std::string_view text) {
+    // Chunks end on game boundaries; several per thread evens out the load
+    const int nthreads = thread_count();
+    const std::size_t target = std::max<std::size_t>(1 << 20, text.size() / ((std::size_t)nthreads * 8));
+
+    std::vector<std::string_view> chunks;
+    std::size_t begin = 0;
+    while (begin < text.size()) {
+        std::size_t end = Pgn::next_game_start(text, std::min(text.size(), begin + target));
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        std::array<std::vector<Sample>, SHARDS> pending;
+        for (std::size_t i; (i = next.fetch_add(1)) < chunks.size();)
+            parse_chunk(chunks[i], pending);
+        for (int sh = 0; sh < SHARDS; ++sh) flush(sh, pending[sh]);
+    };
+
+    std::vector<std::thread> pool;
+    const int n = std::min<int>(nthreads, (int)chunks.size());
+    for (int t = 1; t < n; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+}
+
+bool BookBuilder::add_pgn_file(const std::string& path, std::string& err) {
+    MappedFile file;
+    if (!file.open(path, err)) return false;
+    add_pgn_text(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()));
+    return true;
+}
+
+static void put_be(unsigned char* p, uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i, v >>= 8) p[i] = (unsigned char)(v & 0xFF);
+}
+
+bool BookBuilder::write(const std::string& path, std::string& err) {
+    struct Record {
+        uint64_t key;
+        uint16_t move;
+        uint32_t weight;
+    };
+
+    // Each shard is a key range: sort them in parallel, write in order
+    std::array<std::vector<Record>, SHARDS> sorted;
+    std::atomic<int> next{0};
+    auto worker = [&]() {
+        for (int sh; (sh = next.fetch_add(1)) < SHARDS;) {
+            std::vector<Record>& out = sorted[sh];
+            for (const auto& [k, c] : shards_[sh].map) {
+                if (c.games < opts_.min_count) continue;
+                uint32_t w = opts_.use_results ? c.points : c.games;
+                if (w > 0) out.push_back({k.key, k.move, w});
+            }
+            std::sort(out.begin(), out.end(), [](const Record& a, const Record& b) {
+                return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+            });
+
+            // Weights are 16 bits: scale each position's moves to fit
+            for (std::size_t i = 0; i < out.size();) {
+                std::size_t j = i;
+                while (j < out.size() && out[j].key == out[i].key) ++j;
+                uint32_t top = out[i].weight;
+                if (top > 0xFFFF) {
+                    for (std::size_t k = i; k < j; ++k)
+                        out[k].weight = std::max<uint32_t>(1, (uint32_t)((uint64_t)out[k].weight * 0xFFFF / top));
+                }
+                i = j;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < std::min(thread_count(), SHARDS); ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        err = "Cannot write " + path;
+        return false;
+    }
+
+    entries_ = 0;
+    std::vector<unsigned char> buf;
+    for (const auto& recs : sorted) {
+        buf.assign(recs.size() * Book::ENTRY_SIZE, 0);
+        unsigned char* p = buf.data();
+        for (const Record& r : recs) {
+            put_be(p, r.key, 8);
+            put_be(p + 8, r.move, 2);
+            put_be(p + 10, r.weight, 2);
+            p += Book::ENTRY_SIZE;   // learn field stays 0
+        }
+        out.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size());
+        entries_ += recs.size();
+    }
+
+    if (!out) {
+        err = "Write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+BookBuildStats BookBuilder::stats() const {
+    BookBuildStats s;
+    s.games = games_.load();
+    s.bad_games = bad_games_.load();
+    s.moves = moves_.load();
+    s.entries = entries_;
+    return s;
+}
+
+} // namespace chess
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "book_builder.hpp"
+
+// Builds a Polyglot opening book from one or more PGN files:
+//   ichigo_book [--depth N] [--min-count N] [--results] [--threads N] in.pgn... out.bin
+
+static void usage() {
+    std::cerr << "usage: ichigo_book [--depth N] [--min-count N] [--results] [--threads N] "
+                 "games.pgn... book.bin\n"
+                 "  --depth N      plies per game to include (default 30)\n"
+                 "  --min-count N  drop moves seen fewer than N times (default 1)\n"
+                 "  --results      weight moves by 2*wins + draws instead of games played\n"
+                 "  --threads N    worker threads (default: all cores)\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    BookBuildOptions opts;
+    std::vector<std::string> files;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--depth" && i + 1 < argc)          opts.max_ply = std::stoi(argv[++i]);
+            else if (a == "--min-count" && i + 1 < argc) opts.min_count = (uint32_t)std::stoul(argv[++i]);
+            else if (a == "--threads" && i + 1 < argc)   opts.threads = std::stoi(argv[++i]);
+            else if (a == "--results")                   opts.use_results = true;
+            else if (a == "-h" || a == "--help")         { usage(); return 0; }
+            else if (a.rfind("--", 0) == 0)              { usage(); return 1; }
+            else files.push_back(a);
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+
+    if (files.size() < 2) {
+        usage();
+        return 1;
+    }
+    const std::string out_path = files.back();
+    files.pop_back();
+
+    auto t0 = std::chrono::steady_clock::now();
+    BookBuilder builder(opts);
+    std::string err;
+
+    for (const auto& f : files) {
+        if (!builder.add_pgn_file(f, err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        BookBuildStats s = builder.stats();
+        std::cout << f << ": " << s.games << " games so far, " << s.bad_games << " skipped\n";
+    }
+
+    if (!builder.write(out_path, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    BookBuildStats s = builder.stats();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "Wrote " << s.entries << " entries to " << out_path << " ("
+              << s.games << " games, " << s.moves << " moves, " << secs << " s)\n";
+    return 0;
+}
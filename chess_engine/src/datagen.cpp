@@ -0,0 +1,161 @@
+#include "datagen.hpp"
+#include "gamestate.hpp"
+#include "movegen.hpp"
+#include "rules.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+namespace chess {
+
+// Captures, en passant and promotions change material: positions whose
+// best move is one of them are not quiet.
+static bool is_quiet(const Position& pos, const Move& m) {
+    if (m.promo != PROMO_NONE || !is_empty(pos.at(m.to))) return false;
+    Piece p = pos.at(m.from);
+    return !((p == Piece::WP || p == Piece::BP) && file_of(m.from) != file_of(m.to));
+}
+
+KeyFilter::KeyFilter(std::size_t bytes) {
+    // A power of two of buckets, at least one, within the budget
+    std::size_t n = 1;
+    while (n * 2 * sizeof(Bucket) <= bytes) n *= 2;
+    buckets_.resize(n);
+}
+
+bool KeyFilter::insert(uint64_t key) {
+    uint64_t* keys = buckets_[key & (buckets_.size() - 1)].keys;
+    for (int i = 0; i < WAYS; ++i) {
+        if (keys[i] == key) {
+            std::rotate(keys, keys + i, keys + i + 1);   // most recent first
+            return false;
+        }
+    }
+    std::copy_backward(keys, keys + WAYS - 1, keys + WAYS);
+    keys[0] = key;
+    return true;
+}
+
+// Returns the result for White; samples get the quiet positions.
+int Datagen::play_game(Searcher& searcher, TranspositionTable& tt, std::mt19937_64& rng,
+                       std::vector<Sample>& samples) {
+    Position pos;
+    std::vector<uint64_t> history;
+    std::string err;
+
+    // Random opening; start over if it already ended the game
+    for (;;) {
+        pos = Position::startpos();
+        history.clear();
+        for (int i = 0; i < opts_.random_plies; ++i) {
+            MoveList ml;
+            MoveGen::generate_legal(pos, ml);
+            if (ml.size == 0) break;
+            std::uniform_int_distribution<int> pick(0, ml.size - 1);
+            history.push_back(pos.key());
+            pos.make_move(ml.moves[pick(rng)], err);
+        }
+        if (MoveGen::has_any_legal_move(pos)) break;
+    }
+
+    samples.clear();
+    tt.clear();
+    searcher.clear();
+
+    SearchLimits limits;
+    limits.nodes = opts_.nodes;
+    int win_run = 0;
+
+    for (int ply = 0;; ++ply) {
+        const Color stm = pos.side_to_move();
+        if (!MoveGen::has_any_legal_move(pos))
+            return Rules::in_check(pos, stm) ? (stm == Color::White ? -1 : 1) : 0;
+        if (GameState::is_insufficient_material(pos) || GameState::is_threefold_repetition(pos, history) ||
+            GameState::is_fifty_move_draw(pos) || ply >= opts_.max_plies)
+            return 0;
+
+        tt.new_search();
+        searcher.set_game_history(history);
+        SearchResult res = searcher.search(pos, limits);
+        if (res.best == Move{} || stop_.load(std::memory_order_relaxed)) return 0;
+
+        // Both sides agreeing on a big score for a while ends the game
+        if (std::abs(res.score) >= opts_.win_score) {
+            if (++win_run >= opts_.win_plies) return res.score > 0 ? 1 : -1;
+        } else {
+            win_run = 0;
+        }
+
+        if (ply >= opts_.skip_plies && !is_mate_score(res.score) && !Rules::in_check(pos, stm) &&
+            is_quiet(pos, res.best))
+            samples.push_back({pos, res.score});
+
+        history.push_back(pos.key());
+        if (!pos.make_move(res.best, err)) return 0;
+    }
+}
+
+void Datagen::worker(int index, DatasetWriter& out, std::mutex& mu, const Progress& progress) {
+    TranspositionTable tt(opts_.hash_mb);
+    Searcher searcher(tt, opts_.params);
+    searcher.set_stop_flag(&stop_);
+
+    std::mt19937_64 rng(opts_.seed ? opts_.seed + (uint64_t)index * 0x9E3779B97F4A7C15ULL
+                                   : std::random_device{}());
+    std::vector<Sample> samples;
+
+    while (!stop_.load(std::memory_order_relaxed) &&
+           games_started_.fetch_add(1, std::memory_order_relaxed) < opts_.games) {
+        const int result = play_game(searcher, tt, rng, samples);
+        if (stop_.load(std::memory_order_relaxed)) break;   // cut short: result unknown
+
+        std::lock_guard<std::mutex> lock(mu);
+        for (const Sample& s : samples) {
+            if (opts_.positions && stats_.positions >= opts_.positions) break;
+            if (!seen_.insert(s.pos.key())) {
+                ++stats_.duplicates;
+                continue;
+            }
+            if (!out.write(s.pos, s.score, result)) {
+                write_failed_ = true;
+                stop();
+                break;
+            }
+            ++stats_.positions;
+        }
+        ++stats_.games;
+        if (result > 0) ++stats_.white_wins;
+        else if (result < 0) ++stats_.black_wins;
+        else ++stats_.draws;
+        if (opts_.positions && stats_.positions >= opts_.positions) stop();
+        if (progress) progress(stats_);
+    }
+}
+
+bool Datagen::run(std::string& err, const Progress& progress) {
+    DatasetWriter out;
+    if (!out.open(opts_.output, err)) return false;
+
+    seen_ = KeyFilter(std::max<std::size_t>(opts_.dedup_mb, 1) << 20);
+    stats_ = DatagenStats{};
+    games_started_ = 0;
+    stop_ = false;
+    write_failed_ = false;
+
+    const int nthreads = opts_.threads > 0 ? opts_.threads
+                                           : std::max(1, (int)std::thread::hardware_concurrency());
+    std::mutex mu;
+    std::vector<std::thread> pool;
+    for (int i = 0; i < nthreads; ++i)
+        pool.emplace_back([&, i]() { worker(i, out, mu, progress); });
+    for (auto& t : pool) t.join();
+
+    if (!out.close(err)) return false;
+    if (write_failed_) {
+        err = "Write failed: " + opts_.output;
+        return false;
+    }
+    return true;
+}
+
+} // namespace chess
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "datagen.hpp"
+
+// Self-play training data:
+//   ichigo_datagen [options] OUT.bin
+
+static void usage() {
+    std::cerr << "usage: ichigo_datagen [options] OUT.bin\n"
+                 "  --games N          maximum number of games (default 1000)\n"
+                 "  --positions N      stop after N positions are written\n"
+                 "  --threads N        games played at once (default: all cores)\n"
+                 "  --nodes N          nodes per move (default 5000)\n"
+                 "  --hash MB          hash per thread (default 8)\n"
+                 "  --random-plies N   random opening moves (default 8)\n"
+                 "  --skip-plies N     plies after the opening before sampling (default 8)\n"
+                 "  --max-plies N      adjudicate longer games as draws (default 400)\n"
+                 "  --dedup-mb MB      duplicate filter memory (default 64)\n"
+                 "  --seed N           reproducible openings per thread\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    DatagenOptions opts;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--games" && i + 1 < argc)             opts.games = std::stoull(argv[++i]);
+            else if (a == "--positions" && i + 1 < argc)    opts.positions = std::stoull(argv[++i]);
+            else if (a == "--threads" && i + 1 < argc)      opts.threads = std::stoi(argv[++i]);
+            else if (a == "--nodes" && i + 1 < argc)        opts.nodes = std::stoull(argv[++i]);
+            else if (a == "--hash" && i + 1 < argc)         opts.hash_mb = (std::size_t)std::max(1, std::stoi(argv[++i]));
+            else if (a == "--random-plies" && i + 1 < argc) opts.random_plies = std::stoi(argv[++i]);
+            else if (a == "--skip-plies" && i + 1 < argc)   opts.skip_plies = std::stoi(argv[++i]);
+            else if (a == "--max-plies" && i + 1 < argc)    opts.max_plies = std::stoi(argv[++i]);
+            else if (a == "--dedup-mb" && i + 1 < argc)     opts.dedup_mb = std::stoull(argv[++i]);
+            else if (a == "--seed" && i + 1 < argc)         opts.seed = std::stoull(argv[++i]);
+            else if (a == "-h" || a == "--help")            { usage(); return 0; }
+            else if (a[0] != '-' && opts.output.empty())    opts.output = a;
+            else                                            { usage(); return 1; }
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    if (opts.output.empty()) {
+        usage();
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsed_s = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    Datagen gen(opts);
+    std::string err;
+    bool ok = gen.run(err, [&](const DatagenStats& s) {
+        if (s.games % 100 != 0) return;
+        double t = elapsed_s();
+        std::fprintf(stderr, "games %llu  positions %llu  dups %llu  (%.0f pos/s)\n",
+                     (unsigned long long)s.games, (unsigned long long)s.positions,
+                     (unsigned long long)s.duplicates, t > 0 ? s.positions / t : 0.0);
+    });
+    if (!ok) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    const DatagenStats& s = gen.stats();
+    std::printf("Games       : %llu (+%llu =%llu -%llu)\n", (unsigned long long)s.games,
+                (unsigned long long)s.white_wins, (unsigned long long)s.draws, (unsigned long long)s.black_wins);
+    std::printf("Positions   : %llu (%llu duplicates dropped)\n", (unsigned long long)s.positions,
+                (unsigned long long)s.duplicates);
+    std::printf("Time (s)    : %.1f\n", elapsed_s());
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "dataset.hpp"
+#include "parse.hpp"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace chess {
+
+namespace {
+
+constexpr char MAGIC[4] = {'I', 'C', 'D', 'S'};
+constexpr uint8_t VERSION = 1;
+
+// A whole result token, for White
+bool result_token(const std::string& s, int& result) {
+    if (s == "1-0") result = 1;
+    else if (s == "0-1") result = -1;
+    else if (s == "1/2-1/2") result = 0;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+bool Dataset::open(const std::string& path, std::string& err) {
+    close();
+    if (!file_.open(path, err)) return false;
+
+    const unsigned char* h = file_.data();
+    if (file_.size() < HEADER_SIZE || std::memcmp(h, MAGIC, 4) != 0) {
+        err = "Not a dataset file: " + path;
+        close();
+        return false;
+    }
+    if (h[4] != VERSION || h[8] != sizeof(DataRecord)) {
+        err = "Unsupported dataset version or record size: " + path;
+        close();
+        return false;
+    }
+    if ((file_.size() - HEADER_SIZE) % sizeof(DataRecord) != 0) {
+        err = "Truncated dataset: " + path;
+        close();
+        return false;
+    }
+
+    const std::size_t n = (file_.size() - HEADER_SIZE) / sizeof(DataRecord);
+    records_ = {reinterpret_cast<const DataRecord*>(h + HEADER_SIZE), n};
+    return true;
+}
+
+void Dataset::close() {
+    records_ = {};
+    file_.close();
+}
+
+std::span<const DataRecord> Dataset::shard(int index, int count) const {
+    const std::size_t n = records_.size(), k = (std::size_t)count, i = (std::size_t)index;
+    const std::size_t begin = n * i / k, end = n * (i + 1) / k;
+    return records_.subspan(begin, end - begin);
+}
+
+bool DatasetWriter::open(const std::string& path, std::string& err) {
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        err = "Cannot write " + path;
+        return false;
+    }
+    path_ = path;
+    count_ = 0;
+
+    unsigned char header[Dataset::HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, 4);
+    header[4] = VERSION;
+    header[8] = sizeof(DataRecord);
+    out_.write(reinterpret_cast<const char*>(header), sizeof(header));
+    return (bool)out_;
+}
+
+bool DatasetWriter::write(const DataRecord& r) {
+    out_.write(reinterpret_cast<const char*>(&r), sizeof(r));
+    ++count_;
+    return (bool)out_;
+}
+
+bool DatasetWriter::write(const Position& pos, int score, int result) {
+    DataRecord r;
+    if (!PackedPosition::pack(pos, r.pos)) return false;
+    r.set_score(score);
+    r.result = (int8_t)result;
+    return write(r);
+}
+
+bool DatasetWriter::parse_text(const std::string& line, Position& pos, int& score, int& result) {
+    // Six FEN fields if they parse, else the four EPD ones
+    std::istringstream in(line);
+    std::string f[6];
+    int nf = 0;
+    while (nf < 6 && in >> f[nf]) ++nf;
+    if (nf < 4) return false;
+
+    const std::string fen = f[0] + " " + f[1] + " " + f[2] + " " + f[3];
+    int used = 4;
+    if (nf == 6 && Parse::fen(fen + " " + f[4] + " " + f[5], pos)) used = 6;
+    else if (!Parse::fen(fen, pos)) return false;
+
+    std::string rest;
+    for (int i = used; i < nf; ++i) rest += f[i] + " ";
+    std::string tail;
+    std::getline(in, tail);
+    rest += tail;
+
+    score = 0;
+    result = 0;
+
+    // A bare result may come first, before any operations
+    std::istringstream head(rest);
+    std::string first;
+    if (head >> first && result_token(first, result)) {
+        std::getline(head, rest);
+    }
+
+    for (const std::string& op : Parse::epd_operations(rest)) {
+        const std::size_t sp = op.find_first_of(" \t");
+        const std::string opcode = op.substr(0, sp);
+        std::string operand = sp == std::string::npos ? "" : op.substr(op.find_first_not_of(" \t", sp));
+
+        if (opcode == "ce") {
+            char* end = nullptr;
+            errno = 0;
+            const long cp = std::strtol(operand.c_str(), &end, 10);
+            if (operand.empty() || *end != '\0' || errno == ERANGE) return false;
+            score = pos.side_to_move() == Color::White ? (int)cp : -(int)cp;
+        } else if (opcode == "c9") {
+            if (operand.size() >= 2 && operand.front() == '"' && operand.back() == '"') {
+                operand = operand.substr(1, operand.size() - 2);
+            }
+            result_token(operand, result);
+        } else {
+            result_token(op, result);   // a trailing bare result
+        }
+    }
+    return true;
+}
+
+bool DatasetWriter::close(std::string& err) {
+    if (!out_.is_open()) return true;
+    out_.close();
+    if (!out_) {
+        err = "Write failed: " + path_;
+        return false;
+    }
+    return true;
+}
+
+} // namespace chess
@@ -0,0 +1,95 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "dataset.hpp"
+#include "render.hpp"
+
+// Converts between text positions and the binary dataset format:
+//   ichigo_dataset pack IN.epd OUT.bin    FEN/EPD lines, optional result
+//                                         token ("1-0", "0-1", "1/2-1/2")
+//                                         and "ce"/"c9" operations
+//   ichigo_dataset dump IN.bin [first [count]]
+//   ichigo_dataset count IN.bin
+
+namespace {
+
+void usage() {
+    std::cerr << "usage: ichigo_dataset pack IN.epd OUT.bin\n"
+                 "       ichigo_dataset dump IN.bin [first [count]]\n"
+                 "       ichigo_dataset count IN.bin\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    if (argc < 3) {
+        usage();
+        return 1;
+    }
+    const std::string cmd = argv[1];
+    std::string err;
+
+    if (cmd == "pack" && argc == 4) {
+        std::ifstream in(argv[2]);
+        if (!in) {
+            std::cerr << "Cannot read " << argv[2] << "\n";
+            return 1;
+        }
+        DatasetWriter w;
+        if (!w.open(argv[3], err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        uint64_t skipped = 0;
+        Position pos;
+        for (std::string line; std::getline(in, line);) {
+            int score = 0, result = 0;
+            if (line.empty()) continue;
+            if (!DatasetWriter::parse_text(line, pos, score, result) || !w.write(pos, score, result)) {
+                ++skipped;
+            }
+        }
+        if (!w.close(err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        std::cerr << w.count() << " positions written, " << skipped << " lines skipped\n";
+        return 0;
+    }
+
+    Dataset ds;
+    if (!ds.open(argv[2], err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    if (cmd == "count") {
+        std::cout << ds.size() << "\n";
+        return 0;
+    }
+
+    if (cmd == "dump") {
+        std::size_t first = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+        std::size_t count = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : ds.size();
+        char fen[Render::FEN_MAX];
+        Position pos;
+        for (std::size_t i = first; i < ds.size() && i - first < count; ++i) {
+            const DataRecord& r = ds[i];
+            if (!r.pos.unpack(pos)) {
+                std::cerr << "Bad record " << i << "\n";
+                return 1;
+            }
+            Render::fen(pos, fen);
+            const char* res = r.result > 0 ? "1-0" : r.result < 0 ? "0-1" : "1/2-1/2";
+            std::cout << fen << " | " << r.score() << " | " << res << "\n";
+        }
+        return 0;
+    }
+
+    usage();
+    return 1;
+}
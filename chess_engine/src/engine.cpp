@@ -0,0 +1,160 @@
+#include "engine.hpp"
+#include <algorithm>
+
+namespace chess {
+
+Engine::Engine() : tt_(16) {
+    set_threads(1);
+}
+
+Engine::~Engine() {
+    stop();
+    wait();
+}
+
+void Engine::set_hash_mb(std::size_t mb) {
+    wait();
+    tt_.resize(mb);
+}
+
+void Engine::set_threads(int n) {
+    wait();
+    n = std::max(1, n);
+    searchers_.clear();
+    for (int i = 0; i < n; ++i) {
+        auto s = std::make_unique<Searcher>(tt_, params_);
+        s->set_stop_flag(&stop_);
+        s->set_ponder_flag(&pondering_);
+        s->set_tablebase(tb_);
+        s->set_game_history(game_keys_);
+        searchers_.push_back(std::move(s));
+    }
+}
+
+void Engine::set_params(const SearchParams& p) {
+    wait();
+    params_ = p;
+    for (auto& s : searchers_) s->set_params(p);
+}
+
+void Engine::set_tablebase(const Tablebase* tb) {
+    wait();
+    tb_ = tb;
+    for (auto& s : searchers_) s->set_tablebase(tb);
+}
+
+void Engine::set_game_history(const std::vector<uint64_t>& keys) {
+    wait();
+    game_keys_ = keys;
+    for (auto& s : searchers_) s->set_game_history(keys);
+}
+
+void Engine::new_game() {
+    wait();
+    tt_.clear();
+    for (auto& s : searchers_) s->clear();
+}
+
+bool Engine::save_hash(const std::string& path, std::string& err) {
+    wait();
+    return tt_.save(path, err);
+}
+
+bool Engine::load_hash(const std::string& path, std::string& err) {
+    wait();
+    return tt_.load(path, err);
+}
+
+uint64_t Engine::total_nodes() const {
+    uint64_t n = 0;
+    for (const auto& s : searchers_) n += s->nodes();
+    return n;
+}
+
+void Engine::go(const Position& pos, const SearchLimits& limits,
+                InfoCallback on_info, DoneCallback on_done) {
+    wait();
+    stop_ = false;
+    pondering_ = limits.ponder;
+    searching_ = true;
+    thread_ = std::thread(&Engine::run, this, pos, limits, std::move(on_info), std::move(on_done));
+}
+
+void Engine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+}
+
+void Engine::ponderhit() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        pondering_ = false;
+    }
+    cv_.notify_all();
+}
+
+void Engine::wait() {
+    if (thread_.joinable()) thread_.join();
+}
+
+SearchResult Engine::search(const Position& pos, const SearchLimits& limits, InfoCallback on_info) {
+    SearchResult out;
+    go(pos, limits, std::move(on_info), [&out](const SearchResult& r) { out = r; });
+    wait();
+    return out;
+}
+
+void Engine::run(Position pos, SearchLimits limits, InfoCallback on_info, DoneCallback on_done) {
+    tt_.new_search();
+    for (auto& s : searchers_) s->reset_nodes();
+
+    // Helpers search the same root with no limits of their own; they only
+    // feed the shared table and are stopped when the main thread is done.
+    SearchLimits helper_limits;
+    helper_limits.depth = limits.depth;
+    helper_limits.infinite = true;
+
+    std::vector<std::thread> helpers;
+    for (std::size_t i = 1; i < searchers_.size(); ++i) {
+        helpers.emplace_back([this, i, &pos, &helper_limits]() {
+            searchers_[i]->search(pos, helper_limits);
+        });
+    }
+
+    // Report node counts summed over all threads
+    InfoCallback report;
+    if (on_info) {
+        report = [this, &on_info](const SearchInfo& info) {
+            SearchInfo all = info;
+            all.nodes = total_nodes();
+            on_info(all);
+        };
+    }
+
+    SearchResult res = searchers_[0]->search(pos, limits, report);
+
+    // "go infinite" must not answer before it is told to stop, and a ponder
+    // search that finished early waits for the hit (or the miss)
+    if (limits.infinite || limits.ponder) {
+        std::unique_lock<std::mutex> lock(mu_);
+        cv_.wait(lock, [this, &limits]() {
+            return stop_.load() || (!limits.infinite && !pondering_.load());
+        });
+    }
+
+    stop_ = true;
+    for (auto& t : helpers) t.join();
+
+    res.nodes = total_nodes();
+    if constexpr (SearchStats::enabled) {
+        for (std::size_t i = 1; i < searchers_.size(); ++i) res.stats.merge(searchers_[i]->stats());
+    }
+    pondering_ = false;
+    searching_ = false;
+    if (on_done) on_done(res);
+}
+
+} // namespace chess
@@ -1,33 +1,68 @@
-#include "eval.hpp"
-
-namespace chess {
-
-static int value(Piece p) {
-    switch (p) {
-        case Piece::WP: return 100;
-        case Piece::WN: return 320;
-        case Piece::WB: return 330;
-        case Piece::WR: return 500;
-        case Piece::WQ: return 900;
-        case Piece::WK: return 0;
-
-        case Piece::BP: return -100;
-        case Piece::BN: return -320;
-        case Piece::BB: return -330;
-        case Piece::BR: return -500;
-        case Piece::BQ: return -900;
-        case Piece::BK: return 0;
-
-        default: return 0;
-    }
-}
-
-int Eval::evaluate(const Position& pos) {
-    int score = 0;
-    for (int sq = 0; sq < 64; ++sq) {
-        score += value(pos.at(sq));
-    }
-    return score;
-}
-
-}
+#include "eval.hpp"
+#include <algorithm>
+
+namespace chess {
+
+static constexpr EvalWeights DEFAULT_WEIGHTS = {{{
+#include "eval_weights.inc"
+}}};
+
+// 0..5 for P N B R Q K of either colour
+static int type_of(Piece p) {
+    return (static_cast<int>(p) - 1) % 6;
+}
+
+const EvalWeights& Eval::weights() {
+    return DEFAULT_WEIGHTS;
+}
+
+int Eval::evaluate(const Position& pos) {
+    return evaluate(pos, DEFAULT_WEIGHTS);
+}
+
+int Eval::evaluate(const Position& pos, const EvalWeights& weights) {
+    const auto& w = weights.w;
+    int score = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p)) continue;
+        const int t = type_of(p);
+        if (is_white(p)) score += w[EvalWeights::MATERIAL + t] + w[EvalWeights::pst_index(t, sq)];
+        else             score -= w[EvalWeights::MATERIAL + t] + w[EvalWeights::pst_index(t, sq ^ 56)];
+    }
+    return score;
+}
+
+int Eval::features(const Position& pos, EvalFeature* out) {
+    int material[6] = {};
+    int n = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p)) continue;
+        const int t = type_of(p);
+        const int sign = is_white(p) ? 1 : -1;
+        material[t] += sign;
+        out[n++] = {(uint16_t)EvalWeights::pst_index(t, sign > 0 ? sq : sq ^ 56), (int16_t)sign};
+    }
+
+    // A white and a black piece can share a table entry: merge, drop zeros
+    std::sort(out, out + n, [](const EvalFeature& a, const EvalFeature& b) { return a.index < b.index; });
+    int m = 0;
+    for (int i = 0; i < n; ++i) {
+        if (m > 0 && out[m - 1].index == out[i].index) out[m - 1].coef += out[i].coef;
+        else out[m++] = out[i];
+        if (out[m - 1].coef == 0) --m;
+    }
+
+    // Material entries sort before the tables
+    int k = 0;
+    for (int t = 0; t < 6; ++t) k += material[t] != 0;
+    std::move_backward(out, out + m, out + m + k);
+    int j = 0;
+    for (int t = 0; t < 6; ++t) {
+        if (material[t] != 0) out[j++] = {(uint16_t)(EvalWeights::MATERIAL + t), (int16_t)material[t]};
+    }
+    return m + k;
+}
+
+}
@@ -1,6 +1,7 @@
 #include "gamestate.hpp"
 #include "rules.hpp"
 #include "movegen.hpp"
+#include <algorithm>
 
 namespace chess {
 
@@ -14,5 +15,42 @@ bool GameState::is_stalemate(const Position& pos, Color who) {
     return !Rules::in_check(pos, who) && !MoveGen::has_any_legal_move(pos);
 }
 
+bool GameState::is_insufficient_material(const Position& pos) {
+    int minors = 0, knights = 0;
+    int bishop_colors = 0;   // bit 0: a light-squared bishop, bit 1: a dark one
+    for (int sq = 0; sq < 64; ++sq) {
+        switch (pos.at(sq)) {
+            case Piece::Empty: case Piece::WK: case Piece::BK:
+                break;
+            case Piece::WN: case Piece::BN:
+                ++minors; ++knights;
+                break;
+            case Piece::WB: case Piece::BB:
+                ++minors;
+                bishop_colors |= ((file_of(sq) + rank_of(sq)) % 2 == 0) ? 2 : 1;
+                break;
+            default:
+                return false;   // pawns, rooks, queens
+        }
+    }
+    if (minors <= 1) return true;
+    return knights == 0 && bishop_colors != 3;
+}
+
+bool GameState::is_fifty_move_draw(const Position& pos) {
+    if (pos.halfmove_clock() < 100) return false;
+    return !is_checkmate(pos, pos.side_to_move());
+}
+
+int GameState::repetitions(const Position& pos, const std::vector<uint64_t>& history) {
+    const int n = (int)history.size();
+    const int reach = std::min(pos.halfmove_clock(), n);
+    int count = 0;
+    for (int k = 2; k <= reach; k += 2) {   // same side to move only
+        if (history[n - k] == pos.key()) ++count;
+    }
+    return count;
+}
+
 } // namespace chess
 
@@ -1,6 +1,10 @@
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <optional>
+#include <random>
+#include <vector>
 
 #include "position.hpp"
 #include "render.hpp"
@@ -9,7 +13,12 @@
 
 #include "movegen.hpp"
 #include "search.hpp"   
-#include "rules.hpp"    
+#include "engine.hpp"
+#include "bench.hpp"
+#include "book.hpp"
+#include "tablebase.hpp"
+#include "rules.hpp"
+#include "gamestate.hpp"    
 
 static std::string sq_str(int sq) {
     char f = char('a' + chess::file_of(sq));
@@ -36,7 +45,36 @@ static std::string move_str(const chess::Move& m) {
     return s;
 }
 
-static void print_status(const chess::Position& pos) {
+// Typed moves may leave out the promotion piece (queen by default)
+static bool same_move(const chess::Move& a, const chess::Move& b) {
+    using namespace chess;
+    auto promo = [](uint8_t p) { return p == PROMO_NONE ? (uint8_t)PROMO_Q : p; };
+    return a.from == b.from && a.to == b.to && promo(a.promo) == promo(b.promo);
+}
+
+static void print_stats(const chess::SearchStats& st) {
+    if (st.iterations.empty()) return;
+    std::printf("  depth  seldepth       nodes      qnodes     ms\n");
+    for (const auto& it : st.iterations) {
+        std::printf("  %5d  %8d  %10llu  %10llu  %5lld\n", it.depth, it.seldepth,
+                    (unsigned long long)it.nodes, (unsigned long long)it.qnodes, (long long)it.time_ms);
+    }
+    std::printf("  nodes %llu (q %llu), seldepth %d, branching %.2f\n", (unsigned long long)st.nodes,
+                (unsigned long long)st.qnodes, st.seldepth, st.branching_factor());
+    std::printf("  beta cutoffs %llu, first move %.1f%%\n", (unsigned long long)st.beta_cutoffs,
+                100.0 * st.first_move_cutoff_rate());
+    std::printf("  hash probes %llu, hits %.1f%%, cutoffs %llu\n", (unsigned long long)st.tt_probes,
+                100.0 * st.tt_hit_rate(), (unsigned long long)st.tt_cutoffs);
+}
+
+// Draws under the repetition and fifty-move rules; history holds the keys
+// of the positions before pos.
+static bool is_rule_draw(const chess::Position& pos, const std::vector<uint64_t>& history) {
+    using namespace chess;
+    return GameState::is_threefold_repetition(pos, history) || GameState::is_fifty_move_draw(pos);
+}
+
+static void print_status(const chess::Position& pos, const std::vector<uint64_t>& history) {
     using namespace chess;
 
     MoveList legal;
@@ -51,15 +89,32 @@ static void print_status(const chess::Position& pos) {
         return;
     }
 
+    if (GameState::is_threefold_repetition(pos, history)) {
+        std::cout << "DRAW by threefold repetition.\n";
+        return;
+    }
+    if (GameState::is_fifty_move_draw(pos)) {
+        std::cout << "DRAW by the fifty-move rule.\n";
+        return;
+    }
+
     if (Rules::in_check(pos, pos.side_to_move())) {
         std::cout << "CHECK.\n";
     }
 }
 
-int main() {
+int main(int argc, char** argv) {
     using namespace chess;
 
+    // ichigo_main bench [depth]: speed and node signature, no game
+    if (argc > 1 && std::string(argv[1]) == "bench") {
+        int depth = argc > 2 ? std::max(1, std::atoi(argv[2])) : Bench::DEFAULT_DEPTH;
+        Bench::report(std::cout, Bench::run(depth, 16, &std::cerr), depth);
+        return 0;
+    }
+
     Position pos = Position::startpos();
+    std::vector<uint64_t> history;   // keys of the positions before pos
 
     std::cout << "Mode select:\n";
     std::cout << "  1) PvP (human vs human)\n";
@@ -76,6 +131,36 @@ int main() {
 
     Color human_side = Color::White;
     int ai_depth = 4;
+    int ai_movetime = 0;   // ms per move; 0 = search to ai_depth
+    bool ponder = true;    // keep thinking on the human's time
+    bool show_stats = false;
+
+    Tablebase tb;   // outlives the engine that probes it
+    Engine engine;
+
+    Book book;
+    std::mt19937_64 book_rng{std::random_device{}()};
+
+    // Background search of the position after the reply the AI expects.
+    // A hit lets it keep going as the real search; a miss just stops it.
+    bool pondering = false;
+    bool ponder_hit = false;
+    Move ponder_move;
+    SearchResult ponder_result;
+
+    auto ai_limits = [&]() {
+        SearchLimits l;
+        if (ai_movetime > 0) l.movetime_ms = ai_movetime;
+        else l.depth = ai_depth;
+        return l;
+    };
+
+    auto stop_pondering = [&]() {
+        if (!pondering) return;
+        engine.stop();
+        engine.wait();
+        pondering = ponder_hit = false;
+    };
 
     if (mode == 2) {
         std::cout << "Play as (w/b)? [w] > ";
@@ -98,13 +183,19 @@ int main() {
         std::cout << "  r / reset\n";
         std::cout << "  mode pvp | mode ai\n";
         std::cout << "  depth N          (ai mode)\n";
+        std::cout << "  movetime MS      (ai mode, 0 = use depth)\n";
+        std::cout << "  ponder on|off    (ai mode)\n";
+        std::cout << "  stats on|off     (ai mode, search statistics after each move)\n";
+        std::cout << "  book FILE|off    (Polyglot opening book)\n";
+        std::cout << "  tb DIR|off       (endgame tables from ichigo_tb)\n";
+        std::cout << "  hash save|load FILE (hash table snapshot)\n";
         std::cout << "  side w|b         (ai mode)\n";
         std::cout << "\n";
     };
 
     std::cout << Render::board_ascii(pos);
     print_help();
-    print_status(pos);
+    print_status(pos, history);
 
     std::string line;
     while (true) {
@@ -116,24 +207,68 @@ int main() {
                 MoveList legal;
                 MoveGen::generate_legal(pos, legal);
 
-                if (legal.size == 0) {
+                if (legal.size == 0 || is_rule_draw(pos, history)) {
                     // game over
-                    print_status(pos);
+                    print_status(pos, history);
                     break;
                 }
 
-                Position tmp = pos; // Search expects non-const reference
-                SearchResult res = Search::minimax(tmp, ai_depth);
+                SearchResult res;
+                std::optional<Move> book_move;
+                if (book.is_open()) book_move = book.pick(pos, book_rng);
+
+                if (book_move) {
+                    stop_pondering();
+                    res.best = *book_move;
+                    res.score = 0;
+                    std::cout << "(book move)\n";
+                } else if (pondering && ponder_hit) {
+                    // Already searching this position: just start the clock
+                    engine.ponderhit();
+                    engine.wait();
+                    res = ponder_result;
+                    pondering = ponder_hit = false;
+                } else {
+                    stop_pondering();
+                    engine.set_game_history(history);
+                    res = engine.search(pos, ai_limits());
+                }
 
                 std::string err;
+                const uint64_t key = pos.key();
                 if (!pos.make_move(res.best, err)) {
                     std::cout << "AI produced illegal move?? " << err << "\n";
                     break;
                 }
+                history.push_back(key);
 
                 std::cout << "AI plays: " << move_str(res.best) << " (score " << res.score << ")\n";
+                std::cout << "PV:";
+                for (const Move& pm : res.pv) std::cout << "  " << move_str(pm);
+                std::cout << "\n";
+                if (show_stats) {
+                    std::cout << std::flush;
+                    print_stats(res.stats);
+                    std::fflush(stdout);
+                }
                 std::cout << Render::board_ascii(pos);
-                print_status(pos);
+                print_status(pos, history);
+
+                if (ponder && res.pv.size() >= 2) {
+                    Position next = pos;
+                    std::string perr;
+                    if (next.make_move(res.pv[1], perr)) {
+                        std::vector<uint64_t> next_history = history;
+                        next_history.push_back(pos.key());
+                        engine.set_game_history(next_history);
+                        SearchLimits l = ai_limits();
+                        l.ponder = true;
+                        ponder_move = res.pv[1];
+                        pondering = true;
+                        ponder_hit = false;
+                        engine.go(next, l, {}, [&ponder_result](const SearchResult& r) { ponder_result = r; });
+                    }
+                }
                 continue;
             }
         }
@@ -145,10 +280,14 @@ int main() {
         if (line == "q" || line == "quit" || line == "exit") break;
         if (line == "h" || line == "help") { print_help(); continue; }
 
+        // Anything but a move attempt invalidates the ponder search
+        if (!Parse::two_squares(line)) stop_pondering();
+
         if (line == "r" || line == "reset") {
             pos = Position::startpos();
+            history.clear();
             std::cout << Render::board_ascii(pos);
-            print_status(pos);
+            print_status(pos, history);
             continue;
         }
 
@@ -175,6 +314,67 @@ int main() {
             }
             continue;
         }
+        if (line.rfind("movetime ", 0) == 0) {
+            if (mode != 2) { std::cout << "movetime only applies in AI mode.\n"; continue; }
+            try {
+                ai_movetime = std::max(0, std::stoi(line.substr(9)));
+                if (ai_movetime > 0) std::cout << "AI thinks " << ai_movetime << " ms per move\n";
+                else std::cout << "AI searches to depth " << ai_depth << "\n";
+            } catch (...) {
+                std::cout << "Invalid movetime.\n";
+            }
+            continue;
+        }
+        if (line.rfind("book ", 0) == 0) {
+            std::string path = line.substr(5);
+            if (path == "off") {
+                book.close();
+                std::cout << "Book off\n";
+                continue;
+            }
+            std::string berr;
+            if (!book.open(path, berr)) std::cout << berr << "\n";
+            else std::cout << "Book loaded: " << book.size() << " entries\n";
+            continue;
+        }
+        if (line.rfind("tb ", 0) == 0) {
+            std::string dir = line.substr(3);
+            engine.set_tablebase(nullptr);
+            tb.clear();
+            if (dir == "off") {
+                std::cout << "Tablebases off\n";
+                continue;
+            }
+            std::string terr;
+            if (!tb.load_dir(dir, terr)) {
+                std::cout << terr << "\n";
+                continue;
+            }
+            engine.set_tablebase(&tb);
+            std::cout << "Loaded " << tb.count() << " tables\n";
+            continue;
+        }
+        if (line.rfind("hash save ", 0) == 0 || line.rfind("hash load ", 0) == 0) {
+            const bool save = (line[5] == 's');
+            const std::string path = line.substr(10);
+            std::string herr;
+            if (save ? engine.save_hash(path, herr) : engine.load_hash(path, herr))
+                std::cout << "Hash " << (save ? "saved to " : "loaded from ") << path << "\n";
+            else
+                std::cout << herr << "\n";
+            continue;
+        }
+        if (line == "ponder on" || line == "ponder off") {
+            ponder = (line == "ponder on");
+            std::cout << "Pondering " << (ponder ? "on" : "off") << "\n";
+            continue;
+        }
+        if (line == "stats on" || line == "stats off") {
+            show_stats = (line == "stats on");
+            if (show_stats && !SearchStats::enabled) std::cout << "Built without ICHIGO_SEARCH_STATS.\n";
+            else std::cout << "Statistics " << (show_stats ? "on" : "off") << "\n";
+            continue;
+        }
         if (line.rfind("side ", 0) == 0) {
             if (mode != 2) { std::cout << "side only applies in AI mode.\n"; continue; }
             char c = line.size() >= 6 ? line[5] : 'w';
@@ -234,13 +434,20 @@ int main() {
         }
 
         std::string err;
+        const uint64_t key = pos.key();
         if (!pos.make_move(m, err)) {
             std::cout << "Illegal move: " << err << "\n";
             continue;
         }
+        history.push_back(key);
+
+        if (pondering) {
+            if (same_move(m, ponder_move)) ponder_hit = true;
+            else stop_pondering();
+        }
 
         std::cout << Render::board_ascii(pos);
-        print_status(pos);
+        print_status(pos, history);
     }
 
     return 0;
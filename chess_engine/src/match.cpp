@@ -0,0 +1,294 @@
+#include "match.hpp"
+#include "gamestate.hpp"
+#include "mapped_file.hpp"
+#include "movegen.hpp"
+#include "parse.hpp"
+#include "render.hpp"
+#include "rules.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace chess {
+
+static double elo_to_score(double elo) { return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+
+static double score_to_elo(double s) {
+    s = std::clamp(s, 1e-6, 1.0 - 1e-6);
+    return 400.0 * std::log10(s / (1.0 - s));
+}
+
+double MatchScore::score() const {
+    return games() ? (wins + 0.5 * draws) / games() : 0.5;
+}
+
+double MatchScore::elo() const { return score_to_elo(score()); }
+
+double MatchScore::elo_error() const {
+    const int n = games();
+    if (n == 0) return 0.0;
+    const double m = score();
+    const double var = (wins * (1 - m) * (1 - m) + draws * (0.5 - m) * (0.5 - m) + losses * m * m) / n;
+    const double d = 1.96 * std::sqrt(var / n);
+    return (score_to_elo(m + d) - score_to_elo(m - d)) / 2.0;
+}
+
+// LLR of H1 against H0 with the game score taken as normally distributed.
+// Half a game of each outcome is added so early one-sided runs (all wins,
+// all draws) still have a non-zero variance.
+double Sprt::llr(const MatchScore& s, double elo0, double elo1) {
+    if (s.games() == 0) return 0.0;
+    const double w = s.wins + 0.5, d = s.draws + 0.5, l = s.losses + 0.5;
+    const double n = w + d + l;
+    const double m = (w + 0.5 * d) / n;
+    const double var = (w * (1 - m) * (1 - m) + d * (0.5 - m) * (0.5 - m) + l * m * m) / n;
+    const double s0 = elo_to_score(elo0), s1 = elo_to_score(elo1);
+    return s.games() * (s1 - s0) * (2 * m - s0 - s1) / (2 * var);
+}
+
+double Sprt::lower_bound(double alpha, double beta) { return std::log(beta / (1 - alpha)); }
+double Sprt::upper_bound(double alpha, double beta) { return std::log((1 - beta) / alpha); }
+
+SprtVerdict Sprt::verdict(const MatchScore& s, const SprtConfig& cfg) {
+    if (!cfg.enabled) return SprtVerdict::None;
+    double v = llr(s, cfg.elo0, cfg.elo1);
+    if (v >= upper_bound(cfg.alpha, cfg.beta)) return SprtVerdict::AcceptH1;
+    if (v <= lower_bound(cfg.alpha, cfg.beta)) return SprtVerdict::AcceptH0;
+    return SprtVerdict::None;
+}
+
+Match::Match(const MatchOptions& opts) : opts_(opts) {}
+
+// One opening per line: EPD/FEN (the first four fields are used) or, if the
+// file looks like PGN, the main line of each game.
+bool Match::load_openings(const std::string& path, std::vector<Opening>& out, std::string& err) {
+    MappedFile file;
+    if (!file.open(path, err)) return false;
+    std::string_view text(reinterpret_cast<const char*>(file.data()), file.size());
+
+    if (text.find("[Event ") != std::string_view::npos) {
+        for (std::string_view g : Pgn::split_games(text)) {
+            PgnGame game;
+            if (!Pgn::parse_game(g, game, err)) return false;
+            Opening o;
+            o.start = game.start;
+            o.moves = std::move(game.moves);
+            o.fen = game.tag("FEN");
+            out.push_back(std::move(o));
+        }
+    } else {
+        std::istringstream in{std::string(text)};
+        for (std::string line; std::getline(in, line);) {
+            std::istringstream ls(line);
+            std::string f[4];
+            if (!(ls >> f[0] >> f[1] >> f[2] >> f[3])) continue;
+            std::string fen4 = f[0] + " " + f[1] + " " + f[2] + " " + f[3];
+            Opening o;
+            FenStatus st = Parse::fen(fen4, o.start);
+            if (!st) {
+                err = std::string("Invalid opening position (") + Parse::fen_error(st.error) + "): " + line;
+                return false;
+            }
+            o.fen = Render::fen(o.start);
+            out.push_back(std::move(o));
+        }
+    }
+    if (out.empty()) {
+        err = "No openings in " + path;
+        return false;
+    }
+    return true;
+}
+
+static std::string today() {
+    std::time_t t = std::time(nullptr);
+    std::tm tm{};
+#ifdef _WIN32
+    localtime_s(&tm, &t);
+#else
+    localtime_r(&t, &tm);
+#endif
+    char buf[16];
+    std::strftime(buf, sizeof buf, "%Y.%m.%d", &tm);
+    return buf;
+}
+
+static std::string time_control_tag(const TimeControl& tc) {
+    if (tc.base_ms <= 0) return "-";
+    std::ostringstream out;
+    out << tc.base_ms / 1000.0;
+    if (tc.inc_ms > 0) out << "+" << tc.inc_ms / 1000.0;
+    return out.str();
+}
+
+GameRecord Match::play_game(const EngineConfig& white, const EngineConfig& black,
+                            const Opening& opening, const MatchOptions& opts,
+                            const std::atomic<bool>* stop) {
+    using Clock = std::chrono::steady_clock;
+
+    GameRecord rec;
+    PgnGame& g = rec.pgn;
+    g.start = opening.start;
+    g.tags = {{"Event", "Ichigo match"}, {"Site", "?"}, {"Date", today()}, {"Round", "?"},
+              {"White", white.name}, {"Black", black.name}, {"Result", "*"}};
+    if (!opening.fen.empty()) {
+        g.tags.emplace_back("SetUp", "1");
+        g.tags.emplace_back("FEN", opening.fen);
+    }
+    g.tags.emplace_back("TimeControl", time_control_tag(opts.tc));
+
+    // The position keeps the fifty-move clock; repetitions need the keys of
+    // every earlier position.
+    Position pos = opening.start;
+    std::vector<uint64_t> history;
+    std::string err;
+
+    auto play = [&](const Move& m) {
+        const uint64_t key = pos.key();
+        if (!pos.make_move(m, err)) return false;
+        g.moves.push_back(m);
+        history.push_back(key);
+        return true;
+    };
+
+    for (const Move& m : opening.moves) {
+        if (!play(m)) break;
+    }
+
+    TranspositionTable tt_w(white.hash_mb), tt_b(black.hash_mb);
+    Searcher sw(tt_w, white.params), sb(tt_b, black.params);
+    sw.set_stop_flag(stop);
+    sb.set_stop_flag(stop);
+
+    int64_t clock[2] = {opts.tc.base_ms, opts.tc.base_ms};
+
+    auto finish = [&](int result, const char* why) {
+        rec.result = result;
+        rec.termination = why;
+        g.result = result > 0 ? "1-0" : result < 0 ? "0-1" : "1/2-1/2";
+        return rec;
+    };
+
+    for (;;) {
+        const Color stm = pos.side_to_move();
+        const int side = (stm == Color::White) ? 0 : 1;
+        const int mover_wins = (stm == Color::White) ? 1 : -1;
+
+        if (!MoveGen::has_any_legal_move(pos))
+            return Rules::in_check(pos, stm) ? finish(-mover_wins, "checkmate") : finish(0, "stalemate");
+        if (GameState::is_insufficient_material(pos)) return finish(0, "insufficient material");
+        if (GameState::is_threefold_repetition(pos, history)) return finish(0, "repetition");
+        if (GameState::is_fifty_move_draw(pos)) return finish(0, "fifty moves");
+        if (opts.max_plies > 0 && (int)g.moves.size() >= opts.max_plies) return finish(0, "adjudication");
+
+        SearchLimits limits;
+        limits.depth = opts.tc.depth;
+        limits.nodes = opts.tc.nodes;
+        limits.movetime_ms = opts.tc.movetime_ms;
+        if (opts.tc.base_ms > 0) {
+            limits.wtime_ms = std::max<int64_t>(1, clock[0]);
+            limits.btime_ms = std::max<int64_t>(1, clock[1]);
+            limits.winc_ms = limits.binc_ms = opts.tc.inc_ms;
+        }
+
+        Searcher& s = side == 0 ? sw : sb;
+        s.set_game_history(history);
+        (side == 0 ? tt_w : tt_b).new_search();
+        const auto t0 = Clock::now();
+        SearchResult res = s.search(pos, limits);
+        const int64_t spent =
+            std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - t0).count();
+
+        if (stop && stop->load(std::memory_order_relaxed)) {
+            rec.aborted = true;
+            return rec;
+        }
+        if (opts.tc.base_ms > 0) {
+            clock[side] -= spent;
+            if (clock[side] < 0) return finish(-mover_wins, "time forfeit");
+            clock[side] += opts.tc.inc_ms;
+        }
+        if (!play(res.best)) return finish(-mover_wins, "illegal move");
+    }
+}
+
+bool Match::run(std::string& err, const Report& on_game) {
+    std::vector<Opening> openings;
+    if (opts_.openings.empty()) openings.emplace_back();
+    else if (!load_openings(opts_.openings, openings, err)) return false;
+
+    if (opts_.seed != 0) {
+        std::mt19937_64 rng(opts_.seed);
+        std::shuffle(openings.begin(), openings.end(), rng);
+    }
+
+    std::ofstream pgn_out;
+    if (!opts_.pgn_path.empty()) {
+        pgn_out.open(opts_.pgn_path, std::ios::app);
+        if (!pgn_out) {
+            err = "Cannot write " + opts_.pgn_path;
+            return false;
+        }
+    }
+
+    const int nthreads = opts_.concurrency > 0 ? opts_.concurrency
+                                               : std::max(1, (int)std::thread::hardware_concurrency());
+
+    // Game i plays opening i/2, with a taking white on even i. Finished
+    // games are scored and written in the order they end.
+    std::atomic<int> next{0};
+    std::atomic<bool> stop{false};
+    std::mutex mu;
+    score_ = MatchScore{};
+    llr_ = 0.0;
+    verdict_ = SprtVerdict::None;
+
+    auto worker = [&]() {
+        for (;;) {
+            int i = next.fetch_add(1);
+            if (i >= opts_.games || stop.load()) return;
+
+            const Opening& o = openings[(std::size_t)(i / 2) % openings.size()];
+            const bool a_white = (i % 2 == 0);
+            GameRecord rec = a_white ? play_game(opts_.a, opts_.b, o, opts_, &stop)
+                                     : play_game(opts_.b, opts_.a, o, opts_, &stop);
+            if (rec.aborted) return;
+            rec.a_white = a_white;
+
+            std::lock_guard<std::mutex> lock(mu);
+            if (stop.load()) return;   // a verdict came in meanwhile
+
+            int a_result = a_white ? rec.result : -rec.result;
+            if (a_result > 0) ++score_.wins;
+            else if (a_result < 0) ++score_.losses;
+            else ++score_.draws;
+
+            for (auto& t : rec.pgn.tags) {
+                if (t.first == "Round") t.second = std::to_string(i + 1);
+                else if (t.first == "Result") t.second = rec.pgn.result;
+            }
+            rec.pgn.tags.emplace_back("Termination", rec.termination);
+            if (pgn_out.is_open()) pgn_out << Pgn::write(rec.pgn) << "\n" << std::flush;
+
+            if (opts_.sprt.enabled) {
+                llr_ = Sprt::llr(score_, opts_.sprt.elo0, opts_.sprt.elo1);
+                verdict_ = Sprt::verdict(score_, opts_.sprt);
+                if (verdict_ != SprtVerdict::None) stop.store(true);
+            }
+            if (on_game) on_game(score_, llr_, rec);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < nthreads; ++t) pool.emplace_back(worker);
+    for (auto& t : pool) t.join();
+    return true;
+}
+
+} // namespace chess
@@ -0,0 +1,118 @@
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "match.hpp"
+
+// Engine-vs-engine match between two search configurations:
+//   ichigo_match [--tc BASE+INC | --movetime MS | --nodes N | --depth N]
+//                [--games N] [--concurrency N] [--openings FILE] [--seed N]
+//                [--a "k=v,..."] [--b "k=v,..."] [--sprt ELO0 ELO1]
+//                [--pgn out.pgn]
+
+static void usage() {
+    std::cerr << "usage: ichigo_match [options]\n"
+                 "  --tc S+INC         clock per game in seconds, e.g. 10+0.1\n"
+                 "  --movetime MS      fixed time per move\n"
+                 "  --nodes N          node budget per move\n"
+                 "  --depth N          depth per move (default 6 if no other limit)\n"
+                 "  --games N          maximum number of games (default 100)\n"
+                 "  --concurrency N    games played at once (default: all cores)\n"
+                 "  --openings FILE    EPD/FEN lines or PGN; each is played with both colours\n"
+                 "  --seed N           shuffle the openings\n"
+                 "  --a SPEC / --b SPEC  search parameters, e.g. \"rfp_margin=80,lmp_base=4\"\n"
+                 "  --a-name / --b-name  engine names in the PGN (default A and B)\n"
+                 "  --hash MB          hash per engine (default 16)\n"
+                 "  --sprt E0 E1       stop early on an SPRT verdict (alpha = beta = 0.05)\n"
+                 "  --max-plies N      adjudicate longer games as draws (default 400)\n"
+                 "  --pgn FILE         append finished games to FILE\n";
+}
+
+// "name=value,name=value"
+static bool parse_params(const std::string& spec, chess::SearchParams& p) {
+    std::istringstream in(spec);
+    for (std::string kv; std::getline(in, kv, ',');) {
+        if (kv.empty()) continue;
+        std::size_t eq = kv.find('=');
+        if (eq == std::string::npos || !p.set(kv.substr(0, eq), std::stoi(kv.substr(eq + 1)))) {
+            std::cerr << "Unknown search parameter: " << kv << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static void parse_tc(const std::string& s, chess::TimeControl& tc) {
+    std::size_t plus = s.find('+');
+    tc.base_ms = (int64_t)(std::stod(s.substr(0, plus)) * 1000);
+    if (plus != std::string::npos) tc.inc_ms = (int64_t)(std::stod(s.substr(plus + 1)) * 1000);
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    MatchOptions opts;
+    opts.a.name = "A";
+    opts.b.name = "B";
+    std::string spec_a, spec_b;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--tc" && i + 1 < argc)               parse_tc(argv[++i], opts.tc);
+            else if (a == "--movetime" && i + 1 < argc)    opts.tc.movetime_ms = std::stoll(argv[++i]);
+            else if (a == "--nodes" && i + 1 < argc)       opts.tc.nodes = std::stoull(argv[++i]);
+            else if (a == "--depth" && i + 1 < argc)       opts.tc.depth = std::stoi(argv[++i]);
+            else if (a == "--games" && i + 1 < argc)       opts.games = std::stoi(argv[++i]);
+            else if (a == "--concurrency" && i + 1 < argc) opts.concurrency = std::stoi(argv[++i]);
+            else if (a == "--openings" && i + 1 < argc)    opts.openings = argv[++i];
+            else if (a == "--seed" && i + 1 < argc)        opts.seed = std::stoull(argv[++i]);
+            else if (a == "--a" && i + 1 < argc)           spec_a = argv[++i];
+            else if (a == "--b" && i + 1 < argc)           spec_b = argv[++i];
+            else if (a == "--a-name" && i + 1 < argc)      opts.a.name = argv[++i];
+            else if (a == "--b-name" && i + 1 < argc)      opts.b.name = argv[++i];
+            else if (a == "--hash" && i + 1 < argc)        opts.a.hash_mb = opts.b.hash_mb = (std::size_t)std::max(1, std::stoi(argv[++i]));
+            else if (a == "--max-plies" && i + 1 < argc)   opts.max_plies = std::stoi(argv[++i]);
+            else if (a == "--pgn" && i + 1 < argc)         opts.pgn_path = argv[++i];
+            else if (a == "--sprt" && i + 2 < argc) {
+                opts.sprt.enabled = true;
+                opts.sprt.elo0 = std::stod(argv[++i]);
+                opts.sprt.elo1 = std::stod(argv[++i]);
+            }
+            else if (a == "-h" || a == "--help")           { usage(); return 0; }
+            else                                           { usage(); return 1; }
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    if (!parse_params(spec_a, opts.a.params) || !parse_params(spec_b, opts.b.params)) return 1;
+    if (opts.tc.base_ms == 0 && opts.tc.movetime_ms == 0 && opts.tc.nodes == 0 && opts.tc.depth == 0) {
+        opts.tc.depth = 6;
+    }
+
+    Match match(opts);
+    std::string err;
+    bool ok = match.run(err, [&](const MatchScore& s, double llr, const GameRecord&) {
+        std::printf("Games %d: +%d -%d =%d  score %.3f  elo %+.1f +/- %.1f", s.games(), s.wins,
+                    s.losses, s.draws, s.score(), s.elo(), s.elo_error());
+        if (opts.sprt.enabled) {
+            std::printf("  llr %.2f [%.2f, %.2f]", llr, Sprt::lower_bound(opts.sprt.alpha, opts.sprt.beta),
+                        Sprt::upper_bound(opts.sprt.alpha, opts.sprt.beta));
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    });
+    if (!ok) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    switch (match.verdict()) {
+        case SprtVerdict::AcceptH1: std::printf("SPRT: H1 accepted (%s is stronger)\n", opts.a.name.c_str()); break;
+        case SprtVerdict::AcceptH0: std::printf("SPRT: H0 accepted\n"); break;
+        default: break;
+    }
+    return 0;
+}
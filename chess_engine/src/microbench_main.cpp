@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "eval.hpp"
+#include "movegen.hpp"
+#include "parse.hpp"
+#include "position.hpp"
+#include "rules.hpp"
+
+// Per-primitive timings over a corpus of real positions (the bench set and
+// every position one legal move away from it):
+//   ichigo_microbench [--reps N] [--min-ms MS] [name-filter]
+//
+// Each repetition runs whole passes over the corpus until at least min-ms
+// has elapsed; ns/op is reported as mean, standard deviation and best.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Results are folded into this so the compiler cannot drop the calls.
+volatile uint64_t g_sink = 0;
+
+struct Corpus {
+    std::vector<chess::Position> positions;
+    std::vector<chess::MoveList> legal;     // legal moves of positions[i]
+};
+
+Corpus build_corpus() {
+    using namespace chess;
+    Corpus c;
+    std::string err;
+    for (const auto& fen : Bench::positions()) {
+        auto root = Parse::fen(fen);
+        if (!root) continue;
+        c.positions.push_back(*root);
+
+        MoveList moves;
+        MoveGen::generate_legal(*root, moves);
+        for (int i = 0; i < moves.size; ++i) {
+            Position child = *root;
+            if (child.make_move(moves.moves[i], err)) c.positions.push_back(child);
+        }
+    }
+    c.legal.resize(c.positions.size());
+    for (std::size_t i = 0; i < c.positions.size(); ++i) {
+        MoveGen::generate_legal(c.positions[i], c.legal[i]);
+    }
+    return c;
+}
+
+// One pass over the corpus; returns the number of operations performed.
+using Pass = std::function<uint64_t(const Corpus&)>;
+
+struct Case {
+    const char* name;
+    Pass pass;
+};
+
+struct Stats {
+    double mean = 0, stddev = 0, best = 0;
+};
+
+Stats measure(const Corpus& c, const Pass& pass, int reps, int64_t min_ms) {
+    // Warmup, and a rough per-pass cost to size the repetitions
+    auto t0 = Clock::now();
+    pass(c);
+    pass(c);
+    double pass_ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / 2;
+    uint64_t passes = std::max<uint64_t>(1, (uint64_t)(min_ms * 1e6 / std::max(pass_ns, 1.0)));
+
+    std::vector<double> samples;
+    for (int r = 0; r < reps; ++r) {
+        uint64_t ops = 0;
+        auto start = Clock::now();
+        for (uint64_t p = 0; p < passes; ++p) ops += pass(c);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        samples.push_back(ns / (double)std::max<uint64_t>(ops, 1));
+    }
+
+    Stats s;
+    for (double x : samples) s.mean += x;
+    s.mean /= samples.size();
+    for (double x : samples) s.stddev += (x - s.mean) * (x - s.mean);
+    s.stddev = samples.size() > 1 ? std::sqrt(s.stddev / (samples.size() - 1)) : 0.0;
+    s.best = *std::min_element(samples.begin(), samples.end());
+    return s;
+}
+
+std::vector<Case> cases() {
+    using namespace chess;
+    return {
+        {"generate_legal", [](const Corpus& c) {
+            uint64_t n = 0;
+            for (const Position& p : c.positions) {
+                MoveList ml;
+                MoveGen::generate_legal(p, ml);
+                g_sink = g_sink + (uint64_t)ml.size;
+                ++n;
+            }
+            return n;
+        }},
+        {"generate_pseudo_legal", [](const Corpus& c) {
+            uint64_t n = 0;
+            for (const Position& p : c.positions) {
+                MoveList ml;
+                MoveGen::generate_pseudo_legal(p, ml);
+                g_sink = g_sink + (uint64_t)ml.size;
+                ++n;
+            }
+            return n;
+        }},
+        {"make_move", [](const Corpus& c) {
+            uint64_t n = 0;
+            std::string err;
+            for (std::size_t i = 0; i < c.positions.size(); ++i) {
+                const MoveList& ml = c.legal[i];
+                for (int j = 0; j < ml.size; ++j) {
+                    Position p = c.positions[i];
+                    g_sink = g_sink + (uint64_t)p.make_move(ml.moves[j], err);
+                    ++n;
+                }
+            }
+            return n;
+        }},
+        {"is_square_attacked", [](const Corpus& c) {
+            uint64_t n = 0;
+            for (const Position& p : c.positions) {
+                for (int sq = 0; sq < 64; ++sq) {
+                    g_sink = g_sink + (uint64_t)Rules::is_square_attacked(p, sq, Color::White)
+                                    + (uint64_t)Rules::is_square_attacked(p, sq, Color::Black);
+                }
+                n += 128;
+            }
+            return n;
+        }},
+        {"in_check", [](const Corpus& c) {
+            uint64_t n = 0;
+            for (const Position& p : c.positions) {
+                g_sink = g_sink + (uint64_t)Rules::in_check(p, p.side_to_move());
+                ++n;
+            }
+            return n;
+        }},
+        {"evaluate", [](const Corpus& c) {
+            uint64_t n = 0;
+            for (const Position& p : c.positions) {
+                g_sink = g_sink + (uint64_t)Eval::evaluate(p);
+                ++n;
+            }
+            return n;
+        }},
+    };
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int reps = 10;
+    int64_t min_ms = 100;
+    std::string filter;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--reps" && i + 1 < argc)        reps = std::max(2, std::stoi(argv[++i]));
+            else if (a == "--min-ms" && i + 1 < argc) min_ms = std::max(1, std::stoi(argv[++i]));
+            else if (a.size() > 1 && a[0] == '-')     throw 0;
+            else filter = a;
+        }
+    } catch (...) {
+        std::cerr << "usage: ichigo_microbench [--reps N] [--min-ms MS] [name-filter]\n";
+        return 1;
+    }
+
+    const Corpus corpus = build_corpus();
+    std::printf("%zu positions, %d repetitions of >= %lld ms\n\n", corpus.positions.size(), reps,
+                (long long)min_ms);
+    std::printf("%-22s %10s %10s %10s %7s\n", "primitive", "ns/op", "stddev", "best", "cv%");
+
+    for (const Case& k : cases()) {
+        if (!filter.empty() && std::string(k.name).find(filter) == std::string::npos) continue;
+        Stats s = measure(corpus, k.pass, reps, min_ms);
+        std::printf("%-22s %10.1f %10.2f %10.1f %7.2f\n", k.name, s.mean, s.stddev, s.best,
+                    s.mean > 0 ? 100.0 * s.stddev / s.mean : 0.0);
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -4,31 +4,16 @@
 
 namespace chess {
 
-static bool side_owns_piece(Color side, Piece p) {
-    return (side == Color::White) ? is_white(p) : is_black(p);
-}
-
-bool MoveGen::is_friend_piece(Piece a, Piece b) {
-    if (is_empty(b)) return false;
-    return (is_white(a) && is_white(b)) || (is_black(a) && is_black(b));
-}
-
-bool MoveGen::is_opponent_piece(Piece a, Piece b) {
-    if (is_empty(b)) return false;
-    return (is_white(a) && is_black(b)) || (is_black(a) && is_white(b));
-}
-
-void MoveGen::gen_pawn(const Position& pos, int from, Piece p, MoveList& out) {
-    const bool white = is_white(p);
-    const int dir = white ? +1 : -1;
-    const int start_rank = white ? 1 : 6;
-    const int last_rank  = white ? 7 : 0;
+template <Color Us>
+void MoveGen::gen_pawn(const Position& pos, int from, MoveList& out) {
+    using T = ColorTraits<Us>;
+    constexpr int dir = T::forward;
 
     const int f = file_of(from);
     const int r = rank_of(from);
 
     auto push_pawn_move = [&](int to) {
-        const bool promotes = (rank_of(to) == last_rank);
+        const bool promotes = (rank_of(to) == T::last_rank);
         if (!promotes) {
             out.push(Move{(uint8_t)from, (uint8_t)to, PROMO_NONE});
         } else {
@@ -39,64 +24,49 @@ void MoveGen::gen_pawn(const Position& pos, int from, Piece p, MoveList& out) {
         }
     };
 
+    // A pawn on the last rank cannot exist, so r + dir stays on the board
+    // for every real position; keep the guard for hand-built ones.
+    const int r1 = r + dir;
+    if (r1 < 0 || r1 >= 8) return;
+
     // 1) one step forward
-    int r1 = r + dir;
-    if (r1 >= 0 && r1 < 8) {
-        int to = make_sq(f, r1);
-        if (is_empty(pos.at(to))) {
-            push_pawn_move(to);
-
-            // 2) two steps from start (only if one-step square was empty)
-            if (r == start_rank) {
-                int r2 = r + 2 * dir;
-                int to2 = make_sq(f, r2);
-                if (is_empty(pos.at(to2))) {
-                    out.push(Move{(uint8_t)from, (uint8_t)to2, PROMO_NONE});
-                }
+    int to = make_sq(f, r1);
+    if (is_empty(pos.at(to))) {
+        push_pawn_move(to);
+
+        // 2) two steps from start (only if one-step square was empty)
+        if (r == T::start_rank) {
+            int to2 = make_sq(f, r + 2 * dir);
+            if (is_empty(pos.at(to2))) {
+                out.push(Move{(uint8_t)from, (uint8_t)to2, PROMO_NONE});
             }
         }
     }
 
     // 3) captures (diagonal)
-    int cap_r = r + dir;
-    if (cap_r >= 0 && cap_r < 8) {
-        if (f - 1 >= 0) {
-            int to = make_sq(f - 1, cap_r);
-            if (is_opponent_piece(p, pos.at(to))) {
-                push_pawn_move(to);
-            }
-        }
-        if (f + 1 < 8) {
-            int to = make_sq(f + 1, cap_r);
-            if (is_opponent_piece(p, pos.at(to))) {
-                push_pawn_move(to);
-            }
-        }
+    if (f - 1 >= 0) {
+        int c = make_sq(f - 1, r1);
+        if (ColorTraits<T::them>::owns(pos.at(c))) push_pawn_move(c);
+    }
+    if (f + 1 < 8) {
+        int c = make_sq(f + 1, r1);
+        if (ColorTraits<T::them>::owns(pos.at(c))) push_pawn_move(c);
     }
 
-    // 4) en passant captures (never a promotion)
+    // 4) en passant captures (never a promotion): the ep square must be one
+    // rank forward and diagonal, with the enemy pawn behind it
     int ep = pos.ep_square();
     if (ep != -1) {
         int ep_f = file_of(ep);
-        int ep_r = rank_of(ep);
-
-        // EP destination must be exactly one rank forward for this pawn
-        if (ep_r == r + dir && std::abs(ep_f - f) == 1) {
-            // ensure captured pawn exists behind ep square
-            int cap_sq = make_sq(ep_f, ep_r - dir);
-            Piece cap = pos.at(cap_sq);
-
-            if (white && cap == Piece::BP) {
-                out.push(Move{(uint8_t)from, (uint8_t)ep, PROMO_NONE});
-            } else if (!white && cap == Piece::WP) {
-                out.push(Move{(uint8_t)from, (uint8_t)ep, PROMO_NONE});
-            }
+        if (rank_of(ep) == r1 && std::abs(ep_f - f) == 1 &&
+            pos.at(make_sq(ep_f, r)) == ColorTraits<T::them>::pawn) {
+            out.push(Move{(uint8_t)from, (uint8_t)ep, PROMO_NONE});
         }
     }
 }
 
-
-void MoveGen::gen_knight(const Position& pos, int from, Piece p, MoveList& out) {
+template <Color Us>
+void MoveGen::gen_knight(const Position& pos, int from, MoveList& out) {
     static const int d[8][2] = {
         {+1,+2},{+2,+1},{+2,-1},{+1,-2},
         {-1,-2},{-2,-1},{-2,+1},{-1,+2}
@@ -107,13 +77,13 @@ void MoveGen::gen_knight(const Position& pos, int from, Piece p, MoveList& out)
         int r = r0 + dd[1];
         if (f < 0 || f >= 8 || r < 0 || r >= 8) continue;
         int to = make_sq(f, r);
-        Piece t = pos.at(to);
-        if (is_friend_piece(p, t)) continue;
+        if (ColorTraits<Us>::owns(pos.at(to))) continue;
         out.push(Move{(uint8_t)from, (uint8_t)to});
     }
 }
 
-void MoveGen::gen_ray(const Position& pos, int from, Piece p, int df_step, int dr_step, MoveList& out) {
+template <Color Us>
+void MoveGen::gen_ray(const Position& pos, int from, int df_step, int dr_step, MoveList& out) {
     int f = file_of(from) + df_step;
     int r = rank_of(from) + dr_step;
     while (f >= 0 && f < 8 && r >= 0 && r < 8) {
@@ -122,7 +92,7 @@ void MoveGen::gen_ray(const Position& pos, int from, Piece p, int df_step, int d
         if (is_empty(t)) {
             out.push(Move{(uint8_t)from, (uint8_t)to});
         } else {
-            if (is_opponent_piece(p, t)) out.push(Move{(uint8_t)from, (uint8_t)to});
+            if (!ColorTraits<Us>::owns(t)) out.push(Move{(uint8_t)from, (uint8_t)to});
             break;
         }
         f += df_step;
@@ -130,26 +100,31 @@ void MoveGen::gen_ray(const Position& pos, int from, Piece p, int df_step, int d
     }
 }
 
-void MoveGen::gen_bishop(const Position& pos, int from, Piece p, MoveList& out) {
-    gen_ray(pos, from, p, +1,+1, out);
-    gen_ray(pos, from, p, -1,+1, out);
-    gen_ray(pos, from, p, +1,-1, out);
-    gen_ray(pos, from, p, -1,-1, out);
+template <Color Us>
+void MoveGen::gen_bishop(const Position& pos, int from, MoveList& out) {
+    gen_ray<Us>(pos, from, +1,+1, out);
+    gen_ray<Us>(pos, from, -1,+1, out);
+    gen_ray<Us>(pos, from, +1,-1, out);
+    gen_ray<Us>(pos, from, -1,-1, out);
 }
 
-void MoveGen::gen_rook(const Position& pos, int from, Piece p, MoveList& out) {
-    gen_ray(pos, from, p, +1, 0, out);
-    gen_ray(pos, from, p, -1, 0, out);
-    gen_ray(pos, from, p, 0, +1, out);
-    gen_ray(pos, from, p, 0, -1, out);
+template <Color Us>
+void MoveGen::gen_rook(const Position& pos, int from, MoveList& out) {
+    gen_ray<Us>(pos, from, +1, 0, out);
+    gen_ray<Us>(pos, from, -1, 0, out);
+    gen_ray<Us>(pos, from, 0, +1, out);
+    gen_ray<Us>(pos, from, 0, -1, out);
 }
 
-void MoveGen::gen_queen(const Position& pos, int from, Piece p, MoveList& out) {
-    gen_bishop(pos, from, p, out);
-    gen_rook(pos, from, p, out);
+template <Color Us>
+void MoveGen::gen_queen(const Position& pos, int from, MoveList& out) {
+    gen_bishop<Us>(pos, from, out);
+    gen_rook<Us>(pos, from, out);
 }
 
-void MoveGen::gen_king(const Position& pos, int from, Piece p, MoveList& out) {
+template <Color Us>
+void MoveGen::gen_king(const Position& pos, int from, MoveList& out) {
+    using T = ColorTraits<Us>;
     int f0 = file_of(from), r0 = rank_of(from);
     for (int df = -1; df <= 1; ++df) {
         for (int dr = -1; dr <= 1; ++dr) {
@@ -158,158 +133,126 @@ void MoveGen::gen_king(const Position& pos, int from, Piece p, MoveList& out) {
             int r = r0 + dr;
             if (f < 0 || f >= 8 || r < 0 || r >= 8) continue;
             int to = make_sq(f, r);
-            Piece t = pos.at(to);
-            if (is_friend_piece(p, t)) continue;
+            if (T::owns(pos.at(to))) continue;
             out.push(Move{(uint8_t)from, (uint8_t)to});
         }
     }
-   
-    // Castling generation (requires rights + emptiness + rook present)
-    bool white = is_white(p);
-    int r = white ? 0 : 7;
-
-    // only if king is on e-file start square
-    if (file_of(from) == 4 && rank_of(from) == r) {
-        uint8_t cr = pos.castling_rights();
-
-        if (white) {
-            // King-side: e1 -> g1, rook h1
-            if ((cr & CR_WK) && pos.at(make_sq(5,0)) == Piece::Empty && pos.at(make_sq(6,0)) == Piece::Empty && pos.at(make_sq(7,0)) == Piece::WR) {
-                out.push(Move{(uint8_t)from, (uint8_t)make_sq(6,0)});
-            }
-            // Queen-side: e1 -> c1, rook a1 (need b1 empty too)
-            if ((cr & CR_WQ) && pos.at(make_sq(3,0)) == Piece::Empty && pos.at(make_sq(2,0)) == Piece::Empty && pos.at(make_sq(1,0)) == Piece::Empty && pos.at(make_sq(0,0)) == Piece::WR) {
-                out.push(Move{(uint8_t)from, (uint8_t)make_sq(2,0)});
-            }
-        } else {
-            // King-side: e8 -> g8
-            if ((cr & CR_BK) && pos.at(make_sq(5,7)) == Piece::Empty && pos.at(make_sq(6,7)) == Piece::Empty && pos.at(make_sq(7,7)) == Piece::BR) {
-                out.push(Move{(uint8_t)from, (uint8_t)make_sq(6,7)});
-            }
-            // Queen-side: e8 -> c8
-            if ((cr & CR_BQ) && pos.at(make_sq(3,7)) == Piece::Empty && pos.at(make_sq(2,7)) == Piece::Empty && pos.at(make_sq(1,7)) == Piece::Empty && pos.at(make_sq(0,7)) == Piece::BR) {
-                out.push(Move{(uint8_t)from, (uint8_t)make_sq(2,7)});
-            }
-        }
-    }
 
+    // Castling generation (requires rights + emptiness + rook present);
+    // attacked squares are checked by the legal filter
+    constexpr int r = T::back_rank;
+    constexpr uint8_t king_side  = (Us == Color::White) ? CR_WK : CR_BK;
+    constexpr uint8_t queen_side = (Us == Color::White) ? CR_WQ : CR_BQ;
+    if (from != make_sq(4, r)) return;
+
+    uint8_t cr = pos.castling_rights();
+    // King-side: e -> g, rook on h
+    if ((cr & king_side) && is_empty(pos.at(make_sq(5, r))) && is_empty(pos.at(make_sq(6, r))) &&
+        pos.at(make_sq(7, r)) == T::rook) {
+        out.push(Move{(uint8_t)from, (uint8_t)make_sq(6, r)});
+    }
+    // Queen-side: e -> c, rook on a (b must be empty too)
+    if ((cr & queen_side) && is_empty(pos.at(make_sq(3, r))) && is_empty(pos.at(make_sq(2, r))) &&
+        is_empty(pos.at(make_sq(1, r))) && pos.at(make_sq(0, r)) == T::rook) {
+        out.push(Move{(uint8_t)from, (uint8_t)make_sq(2, r)});
+    }
 }
 
+template <Color Us>
 void MoveGen::generate_pseudo_legal(const Position& pos, MoveList& out) {
+    using T = ColorTraits<Us>;
     out.clear();
-    Color stm = pos.side_to_move();
 
     for (int from = 0; from < 64; ++from) {
-        Piece p = pos.at(from);
-        if (is_empty(p)) continue;
-        if (!side_owns_piece(stm, p)) continue;
-
-        switch (p) {
-            case Piece::WP:
-            case Piece::BP: gen_pawn(pos, from, p, out); break;
-
-            case Piece::WN:
-            case Piece::BN: gen_knight(pos, from, p, out); break;
-
-            case Piece::WB:
-            case Piece::BB: gen_bishop(pos, from, p, out); break;
-
-            case Piece::WR:
-            case Piece::BR: gen_rook(pos, from, p, out); break;
-
-            case Piece::WQ:
-            case Piece::BQ: gen_queen(pos, from, p, out); break;
-
-            case Piece::WK:
-            case Piece::BK: gen_king(pos, from, p, out); break;
-
-            default: break;
-        }
+        const Piece p = pos.at(from);
+        if (!T::owns(p)) continue;
+
+        if (p == T::pawn)        gen_pawn<Us>(pos, from, out);
+        else if (p == T::knight) gen_knight<Us>(pos, from, out);
+        else if (p == T::bishop) gen_bishop<Us>(pos, from, out);
+        else if (p == T::rook)   gen_rook<Us>(pos, from, out);
+        else if (p == T::queen)  gen_queen<Us>(pos, from, out);
+        else                     gen_king<Us>(pos, from, out);
     }
 }
 
+template <Color Us>
 void MoveGen::generate_legal(const Position& pos, MoveList& out) {
+    using T = ColorTraits<Us>;
+
     MoveList pseudo;
-    generate_pseudo_legal(pos, pseudo);
+    generate_pseudo_legal<Us>(pos, pseudo);
 
     out.clear();
-    Color mover = pos.side_to_move();
 
     for (int i = 0; i < pseudo.size; ++i) {
         const Move& m = pseudo.moves[i];
+        const Piece moving = pos.at(m.from);
+        const bool castle = (moving == T::king) && std::abs(file_of(m.to) - file_of(m.from)) == 2;
 
         // Castling: must also satisfy "not in check, not through check, not into check"
-        if (Rules::is_castle_move(pos, m)) {
+        if (castle) {
             std::string cerr;
             if (!Rules::castle_path_safe(pos, m, cerr)) continue;
         }
 
         // Apply on copy
         Position tmp = pos;
-        Piece moving = tmp.at(m.from);
-
         tmp.set(m.to, moving);
         tmp.set(m.from, Piece::Empty);
 
         // If castling, move rook on tmp too (so in_check reflects true post-move board)
-        if (Rules::is_castle_move(pos, m)) {
-            int r = (moving == Piece::WK) ? 0 : 7;
-            bool king_side = (file_of(m.to) == 6);
-            if (king_side) {
-                // rook h -> f
-                tmp.set(make_sq(5, r), tmp.at(make_sq(7, r)));
+        if (castle) {
+            constexpr int r = T::back_rank;
+            if (file_of(m.to) == 6) {
+                tmp.set(make_sq(5, r), tmp.at(make_sq(7, r)));   // rook h -> f
                 tmp.set(make_sq(7, r), Piece::Empty);
             } else {
-                // rook a -> d
-                tmp.set(make_sq(3, r), tmp.at(make_sq(0, r)));
+                tmp.set(make_sq(3, r), tmp.at(make_sq(0, r)));   // rook a -> d
                 tmp.set(make_sq(0, r), Piece::Empty);
             }
         }
 
-        // If move is en passant capture, remove the captured pawn behind the EP square
-        if ((moving == Piece::WP || moving == Piece::BP) &&
-            pos.ep_square() == m.to &&
-            is_empty(pos.at(m.to))) {
-
-            int df = file_of(m.to) - file_of(m.from);
-            int dr = rank_of(m.to) - rank_of(m.from);
-            int dir = (moving == Piece::WP) ? +1 : -1;
-
-            if (std::abs(df) == 1 && dr == dir) {
-                int cap_sq = make_sq(file_of(m.to), rank_of(m.to) - dir);
-                tmp.set(cap_sq, Piece::Empty);
+        if (moving == T::pawn) {
+            // En passant: remove the captured pawn behind the EP square
+            if (pos.ep_square() == m.to && file_of(m.to) != file_of(m.from) && is_empty(pos.at(m.to))) {
+                tmp.set(make_sq(file_of(m.to), rank_of(m.to) - T::forward), Piece::Empty);
             }
-        }
 
-        // Promotion: if pawn reaches last rank, replace it for correct check testing
-        if (moving == Piece::WP || moving == Piece::BP) {
-            int last_rank = (moving == Piece::WP) ? 7 : 0;
-            if (rank_of(m.to) == last_rank) {
-                uint8_t pr = m.promo;
-                if (pr == PROMO_NONE) pr = PROMO_Q; // default to queen
-
-                Piece promoted = Piece::Empty;
-                bool white = (moving == Piece::WP);
-
-                switch (pr) {
-                    case PROMO_Q: promoted = white ? Piece::WQ : Piece::BQ; break;
-                    case PROMO_R: promoted = white ? Piece::WR : Piece::BR; break;
-                    case PROMO_B: promoted = white ? Piece::WB : Piece::BB; break;
-                    case PROMO_N: promoted = white ? Piece::WN : Piece::BN; break;
-                    default:      promoted = white ? Piece::WQ : Piece::BQ; break;
+            // Promotion: replace the pawn for correct check testing
+            if (rank_of(m.to) == T::last_rank) {
+                Piece promoted = T::queen;   // also the default for PROMO_NONE
+                switch (m.promo) {
+                    case PROMO_R: promoted = T::rook; break;
+                    case PROMO_B: promoted = T::bishop; break;
+                    case PROMO_N: promoted = T::knight; break;
+                    default: break;
                 }
-
                 tmp.set(m.to, promoted);
             }
         }
 
         // If mover is still in check, illegal
-        if (Rules::in_check(tmp, mover)) continue;
+        if (Rules::in_check<Us>(tmp)) continue;
 
         out.push(m);
     }
 }
 
+template void MoveGen::generate_pseudo_legal<Color::White>(const Position&, MoveList&);
+template void MoveGen::generate_pseudo_legal<Color::Black>(const Position&, MoveList&);
+template void MoveGen::generate_legal<Color::White>(const Position&, MoveList&);
+template void MoveGen::generate_legal<Color::Black>(const Position&, MoveList&);
+
+void MoveGen::generate_pseudo_legal(const Position& pos, MoveList& out) {
+    if (pos.side_to_move() == Color::White) generate_pseudo_legal<Color::White>(pos, out);
+    else generate_pseudo_legal<Color::Black>(pos, out);
+}
+
+void MoveGen::generate_legal(const Position& pos, MoveList& out) {
+    if (pos.side_to_move() == Color::White) generate_legal<Color::White>(pos, out);
+    else generate_legal<Color::Black>(pos, out);
+}
 
 bool MoveGen::has_any_legal_move(const Position& pos) {
     MoveList legal;
@@ -318,4 +261,3 @@ bool MoveGen::has_any_legal_move(const Position& pos) {
 }
 
 } // namespace chess
-
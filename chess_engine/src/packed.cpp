@@ -0,0 +1,63 @@
+#include "packed.hpp"
+#include <bit>
+#include <cstring>
+
+namespace chess {
+
+bool PackedPosition::pack(const Position& pos, PackedPosition& out) {
+    out = PackedPosition{};
+    uint64_t occ = 0;
+    int n = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p)) continue;
+        if (n == MAX_PIECES) return false;
+        occ |= 1ULL << sq;
+        out.bytes[8 + n / 2] |= (uint8_t)(static_cast<int>(p) << (4 * (n & 1)));
+        ++n;
+    }
+    for (int i = 0; i < 8; ++i) out.bytes[i] = (uint8_t)(occ >> (8 * i));
+
+    out.bytes[24] = (uint8_t)((pos.side_to_move() == Color::Black ? 1 : 0) | (pos.castling_rights() << 1));
+    out.bytes[25] = pos.ep_square() == -1 ? 0xFF : (uint8_t)pos.ep_square();
+    out.bytes[26] = (uint8_t)pos.halfmove_clock();
+    out.bytes[27] = (uint8_t)(pos.halfmove_clock() >> 8);
+    out.bytes[28] = (uint8_t)pos.fullmove_number();
+    out.bytes[29] = (uint8_t)(pos.fullmove_number() >> 8);
+    return true;
+}
+
+bool PackedPosition::unpack(Position& out) const {
+    uint64_t occ = 0;
+    for (int i = 0; i < 8; ++i) occ |= (uint64_t)bytes[i] << (8 * i);
+    if (std::popcount(occ) > MAX_PIECES) return false;
+
+    out = Position();
+    int n = 0;
+    for (uint64_t b = occ; b; b &= b - 1) {
+        int code = (bytes[8 + n / 2] >> (4 * (n & 1))) & 0xF;
+        if (code < static_cast<int>(Piece::WP) || code > static_cast<int>(Piece::BK)) return false;
+        out.set(std::countr_zero(b), static_cast<Piece>(code));
+        ++n;
+    }
+
+    const uint8_t flags = bytes[24];
+    if (flags & 0xE0) return false;
+    out.set_side_to_move((flags & 1) ? Color::Black : Color::White);
+    out.set_castling_rights((uint8_t)(flags >> 1));
+
+    const uint8_t ep = bytes[25];
+    if (ep != 0xFF) {
+        if (ep >= 64) return false;
+        out.set_ep_square(ep);
+    }
+    out.set_halfmove_clock(bytes[26] | (bytes[27] << 8));
+    out.set_fullmove_number(bytes[28] | (bytes[29] << 8));
+    return true;
+}
+
+bool PackedPosition::operator==(const PackedPosition& o) const {
+    return std::memcmp(bytes, o.bytes, sizeof(bytes)) == 0;
+}
+
+} // namespace chess
@@ -1,4 +1,6 @@
 #include "parse.hpp"
+#include "movegen.hpp"
+#include <algorithm>
 #include <cctype>
 #include <sstream>
 
@@ -45,5 +47,281 @@ std::optional<std::pair<int,int>> Parse::two_squares(const std::string& line0) {
     return std::make_pair(*sqa, *sqb);
 }
 
-} // namespace chess
+std::optional<Move> Parse::uci_move(const std::string& s0) {
+    std::string s = trim_copy(s0);
+    if (s.size() != 4 && s.size() != 5) return std::nullopt;
+
+    auto from = square(s.substr(0, 2));
+    auto to   = square(s.substr(2, 2));
+    if (!from || !to) return std::nullopt;
+
+    Move m;
+    m.from = static_cast<uint8_t>(*from);
+    m.to   = static_cast<uint8_t>(*to);
+    if (s.size() == 5) {
+        switch (std::tolower((unsigned char)s[4])) {
+            case 'q': m.promo = PROMO_Q; break;
+            case 'r': m.promo = PROMO_R; break;
+            case 'b': m.promo = PROMO_B; break;
+            case 'n': m.promo = PROMO_N; break;
+            default: return std::nullopt;
+        }
+    }
+    return m;
+}
+
+// 'P', 'N', 'B', 'R', 'Q' or 'K' for either colour
+static char kind_char(Piece p) {
+    return "PNBRQK"[(static_cast<int>(p) - 1) % 6];
+}
+
+std::optional<Move> Parse::san(const Position& pos, std::string_view s) {
+    // Check marks and annotation glyphs carry no move information
+    while (!s.empty() && (s.back() == '+' || s.back() == '#' || s.back() == '!' || s.back() == '?'))
+        s.remove_suffix(1);
+    if (s.size() < 2) return std::nullopt;
+
+    MoveList legal;
+    MoveGen::generate_legal(pos, legal);
+
+    const int home = (pos.side_to_move() == Color::White) ? 0 : 7;
+    int castle_file = -1;
+    if (s == "O-O" || s == "0-0") castle_file = 6;
+    else if (s == "O-O-O" || s == "0-0-0") castle_file = 2;
+    if (castle_file != -1) {
+        const int from = make_sq(4, home), to = make_sq(castle_file, home);
+        for (int i = 0; i < legal.size; ++i) {
+            const Move& m = legal.moves[i];
+            if (m.from == from && m.to == to && kind_char(pos.at(from)) == 'K') return m;
+        }
+        return std::nullopt;
+    }
+
+    // Promotion: "e8=Q", also the older "e8Q"
+    uint8_t promo = PROMO_NONE;
+    char pc = s.back();
+    if (pc == 'Q' || pc == 'R' || pc == 'B' || pc == 'N') {
+        if (s.size() >= 3 && (s[s.size() - 2] == '=' || (s[s.size() - 2] >= '1' && s[s.size() - 2] <= '8'))) {
+            promo = (pc == 'Q') ? PROMO_Q : (pc == 'R') ? PROMO_R : (pc == 'B') ? PROMO_B : PROMO_N;
+            s.remove_suffix(s[s.size() - 2] == '=' ? 2 : 1);
+        }
+    }
 
+    char kind = 'P';
+    if (s[0] == 'N' || s[0] == 'B' || s[0] == 'R' || s[0] == 'Q' || s[0] == 'K') {
+        kind = s[0];
+        s.remove_prefix(1);
+    }
+    if (s.size() < 2) return std::nullopt;
+
+    const char tf = s[s.size() - 2], tr = s[s.size() - 1];
+    if (tf < 'a' || tf > 'h' || tr < '1' || tr > '8') return std::nullopt;
+    const int to = make_sq(tf - 'a', tr - '1');
+    s.remove_suffix(2);
+
+    // Whatever is left is disambiguation and the capture mark
+    int from_file = -1, from_rank = -1;
+    for (char c : s) {
+        if (c >= 'a' && c <= 'h') from_file = c - 'a';
+        else if (c >= '1' && c <= '8') from_rank = c - '1';
+        else if (c != 'x' && c != ':') return std::nullopt;
+    }
+
+    std::optional<Move> found;
+    for (int i = 0; i < legal.size; ++i) {
+        const Move& m = legal.moves[i];
+        if (m.to != to || m.promo != promo) continue;
+        if (kind_char(pos.at(m.from)) != kind) continue;
+        if (from_file != -1 && file_of(m.from) != from_file) continue;
+        if (from_rank != -1 && rank_of(m.from) != from_rank) continue;
+        if (found) return std::nullopt;   // ambiguous
+        found = m;
+    }
+    return found;
+}
+
+static Piece piece_from_char(char c) {
+    switch (c) {
+        case 'P': return Piece::WP;
+        case 'N': return Piece::WN;
+        case 'B': return Piece::WB;
+        case 'R': return Piece::WR;
+        case 'Q': return Piece::WQ;
+        case 'K': return Piece::WK;
+        case 'p': return Piece::BP;
+        case 'n': return Piece::BN;
+        case 'b': return Piece::BB;
+        case 'r': return Piece::BR;
+        case 'q': return Piece::BQ;
+        case 'k': return Piece::BK;
+        default:  return Piece::Empty;
+    }
+}
+
+static bool is_fen_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// The next whitespace-separated field of s at or after pos
+static std::string_view next_field(std::string_view s, std::size_t& pos) {
+    while (pos < s.size() && is_fen_space(s[pos])) ++pos;
+    std::size_t begin = pos;
+    while (pos < s.size() && !is_fen_space(s[pos])) ++pos;
+    return s.substr(begin, pos - begin);
+}
+
+// Decimal 0..65535, as the clocks are stored in 16 bits
+static bool parse_clock(std::string_view f, int& out) {
+    if (f.empty() || f.size() > 5) return false;
+    int v = 0;
+    for (char c : f) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+    }
+    if (v > 0xFFFF) return false;
+    out = v;
+    return true;
+}
+
+FenStatus Parse::fen(std::string_view fen, Position& out) {
+    std::size_t at = 0;
+    auto fail = [&](FenError e, std::string_view field) {
+        return FenStatus{e, (int)(field.data() - fen.data())};
+    };
+
+    out = Position();
+
+    // Board: ranks 8..1, files a..h
+    std::string_view board = next_field(fen, at);
+    if (board.empty()) return fail(FenError::MissingField, board);
+    int file = 0, rank = 7;
+    int kings[2] = {0, 0};
+    for (char c : board) {
+        if (c == '/') {
+            if (file != 8 || rank == 0) return fail(FenError::Board, board);
+            file = 0;
+            --rank;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+            if (file > 8) return fail(FenError::Board, board);
+        } else {
+            Piece p = piece_from_char(c);
+            if (p == Piece::Empty || file > 7) return fail(FenError::Board, board);
+            if ((p == Piece::WP || p == Piece::BP) && (rank == 0 || rank == 7))
+                return fail(FenError::PawnOnBackRank, board);
+            if (p == Piece::WK) ++kings[0];
+            if (p == Piece::BK) ++kings[1];
+            out.set(make_sq(file, rank), p);
+            ++file;
+        }
+    }
+    if (file != 8 || rank != 0) return fail(FenError::Board, board);
+    if (kings[0] != 1 || kings[1] != 1) return fail(FenError::Kings, board);
+
+    std::string_view stm = next_field(fen, at);
+    if (stm.empty()) return fail(FenError::MissingField, stm);
+    if (stm == "w") out.set_side_to_move(Color::White);
+    else if (stm == "b") out.set_side_to_move(Color::Black);
+    else return fail(FenError::SideToMove, stm);
+
+    // Each right needs its king and rook still at home
+    std::string_view castling = next_field(fen, at);
+    uint8_t cr = CR_NONE;
+    if (!castling.empty() && castling != "-") {
+        for (char c : castling) {
+            uint8_t bit = 0;
+            Piece king = Piece::WK, rook = Piece::WR;
+            int rank_home = 0, rook_file = 7;
+            switch (c) {
+                case 'K': bit = CR_WK; break;
+                case 'Q': bit = CR_WQ; rook_file = 0; break;
+                case 'k': bit = CR_BK; king = Piece::BK; rook = Piece::BR; rank_home = 7; break;
+                case 'q': bit = CR_BQ; king = Piece::BK; rook = Piece::BR; rank_home = 7; rook_file = 0; break;
+                default: return fail(FenError::Castling, castling);
+            }
+            if ((cr & bit) || out.at(make_sq(4, rank_home)) != king ||
+                out.at(make_sq(rook_file, rank_home)) != rook)
+                return fail(FenError::Castling, castling);
+            cr |= bit;
+        }
+    }
+    out.set_castling_rights(cr);
+
+    // The square passed over: empty, with the pushed pawn in front of it
+    std::string_view ep = next_field(fen, at);
+    if (!ep.empty() && ep != "-") {
+        if (ep.size() != 2 || ep[0] < 'a' || ep[0] > 'h') return fail(FenError::EnPassant, ep);
+        const bool white = out.side_to_move() == Color::White;
+        const int f = ep[0] - 'a';
+        const int r = white ? 5 : 2;
+        const int dir = white ? -1 : 1;
+        if (ep[1] != '1' + r || out.at(make_sq(f, r)) != Piece::Empty ||
+            out.at(make_sq(f, r - dir)) != Piece::Empty ||
+            out.at(make_sq(f, r + dir)) != (white ? Piece::BP : Piece::WP))
+            return fail(FenError::EnPassant, ep);
+        out.set_ep_square(make_sq(f, r));
+    }
+
+    int halfmove = 0, fullmove = 1;
+    std::string_view hm = next_field(fen, at);
+    if (!hm.empty() && !parse_clock(hm, halfmove)) return fail(FenError::HalfmoveClock, hm);
+    std::string_view fm = next_field(fen, at);
+    if (!fm.empty() && !parse_clock(fm, fullmove)) return fail(FenError::FullmoveNumber, fm);
+    out.set_halfmove_clock(halfmove);
+    out.set_fullmove_number(fullmove);
+
+    std::string_view rest = next_field(fen, at);
+    if (!rest.empty()) return fail(FenError::TrailingInput, rest);
+    return {};
+}
+
+std::optional<Position> Parse::fen(std::string_view text) {
+    Position pos;
+    if (!fen(text, pos)) return std::nullopt;
+    return pos;
+}
+
+// EPD operations are "opcode operands;" with operands that may be quoted
+// strings, which can themselves hold ';'.
+std::vector<std::string> Parse::epd_operations(std::string_view text) {
+    std::vector<std::string> ops;
+    std::string cur;
+    bool quoted = false;
+    for (char c : text) {
+        if (c == '"') quoted = !quoted;
+        if (c == ';' && !quoted) {
+            ops.push_back(cur);
+            cur.clear();
+        } else {
+            cur += c;
+        }
+    }
+    ops.push_back(cur);
+
+    for (auto& op : ops) {
+        const std::size_t b = op.find_first_not_of(" \t\r");
+        const std::size_t e = op.find_last_not_of(" \t\r");
+        op = (b == std::string::npos) ? "" : op.substr(b, e - b + 1);
+    }
+    ops.erase(std::remove(ops.begin(), ops.end(), std::string()), ops.end());
+    return ops;
+}
+
+const char* Parse::fen_error(FenError e) {
+    switch (e) {
+        case FenError::None:           return "ok";
+        case FenError::MissingField:   return "missing field";
+        case FenError::Board:          return "bad board";
+        case FenError::Kings:          return "need one king per side";
+        case FenError::PawnOnBackRank: return "pawn on back rank";
+        case FenError::SideToMove:     return "bad side to move";
+        case FenError::Castling:       return "bad castling rights";
+        case FenError::EnPassant:      return "bad en passant square";
+        case FenError::HalfmoveClock:  return "bad halfmove clock";
+        case FenError::FullmoveNumber: return "bad fullmove number";
+        case FenError::TrailingInput:  return "trailing input";
+    }
+    return "unknown";
+}
+
+} // namespace chess
@@ -0,0 +1,227 @@
+#include "pgn.hpp"
+#include "parse.hpp"
+#include "render.hpp"
+#include <cctype>
+
+namespace chess {
+
+std::string PgnGame::tag(const std::string& name) const {
+    for (const auto& t : tags)
+        if (t.first == name) return t.second;
+    return "";
+}
+
+static bool is_blank(std::string_view line) {
+    for (char c : line)
+        if (!std::isspace((unsigned char)c)) return false;
+    return true;
+}
+
+static bool is_result(std::string_view tok) {
+    return tok == "1-0" || tok == "0-1" || tok == "1/2-1/2" || tok == "*";
+}
+
+std::vector<std::string_view> Pgn::split_games(std::string_view text) {
+    std::vector<std::string_view> games;
+    std::size_t start = std::string_view::npos;
+    bool in_moves = false;
+
+    std::size_t i = 0;
+    while (i < text.size()) {
+        std::size_t eol = text.find('\n', i);
+        if (eol == std::string_view::npos) eol = text.size();
+        std::string_view line = text.substr(i, eol - i);
+
+        if (!is_blank(line)) {
+            std::size_t first = line.find_first_not_of(" \t\r");
+            bool tag = (line[first] == '[');
+            if (tag && (start == std::string_view::npos || in_moves)) {
+                // A tag after movetext opens the next game
+                if (start != std::string_view::npos) games.push_back(text.substr(start, i - start));
+                start = i;
+                in_moves = false;
+            } else if (!tag) {
+                if (start == std::string_view::npos) start = i;
+                in_moves = true;
+            }
+        }
+        i = eol + 1;
+    }
+
+    if (start != std::string_view::npos) games.push_back(text.substr(start));
+    return games;
+}
+
+std::size_t Pgn::next_game_start(std::string_view text, std::size_t from) {
+    if (from == 0) return 0;
+    if (from >= text.size()) return text.size();
+    std::size_t p = text.find("\n[Event ", from - 1);
+    return (p == std::string_view::npos) ? text.size() : p + 1;
+}
+
+bool Pgn::parse_game(std::string_view text, PgnGame& out, std::string& err,
+                     int max_plies, const PgnMoveVisitor& on_move) {
+    out = PgnGame{};
+    err.clear();
+
+    Position pos;
+    bool in_moves = false;
+
+    // The FEN tag, if any, fixes the start position before the first move
+    auto begin_moves = [&]() -> bool {
+        if (in_moves) return true;
+        in_moves = true;
+        std::string fen = out.tag("FEN");
+        if (!fen.empty()) {
+            FenStatus st = Parse::fen(fen, out.start);
+            if (!st) {
+                err = std::string("Invalid FEN tag (") + Parse::fen_error(st.error) + "): " + fen;
+                return false;
+            }
+        }
+        pos = out.start;
+        return true;
+    };
+
+    std::size_t i = 0;
+    const std::size_t n = text.size();
+    while (i < n) {
+        char c = text[i];
+
+        if (std::isspace((unsigned char)c)) {
+            ++i;
+        } else if (c == '[' && !in_moves) {
+            // [Name "value"]
+            std::size_t close = text.find(']', i);
+            if (close == std::string_view::npos) close = n;
+            std::string_view body = text.substr(i + 1, close - i - 1);
+            std::size_t q1 = body.find('"');
+            std::size_t q2 = body.rfind('"');
+            if (q1 != std::string_view::npos && q2 > q1) {
+                std::string name(body.substr(0, q1));
+                while (!name.empty() && std::isspace((unsigned char)name.back())) name.pop_back();
+                std::string value;
+                for (std::size_t k = q1 + 1; k < q2; ++k) {
+                    if (body[k] == '\\' && k + 1 < q2) ++k;
+                    value += body[k];
+                }
+                out.tags.emplace_back(std::move(name), std::move(value));
+            }
+            i = close + 1;
+        } else if (c == '{') {
+            std::size_t close = text.find('}', i);
+            i = (close == std::string_view::npos) ? n : close + 1;
+        } else if (c == ';' || (c == '%' && (i == 0 || text[i - 1] == '\n'))) {
+            std::size_t eol = text.find('\n', i);
+            i = (eol == std::string_view::npos) ? n : eol + 1;
+        } else if (c == '(') {
+            // Variations nest and may hold comments
+            int depth = 0;
+            for (; i < n; ++i) {
+                if (text[i] == '(') ++depth;
+                else if (text[i] == ')' && --depth == 0) { ++i; break; }
+                else if (text[i] == '{') {
+                    std::size_t close = text.find('}', i);
+                    i = (close == std::string_view::npos) ? n - 1 : close;
+                }
+            }
+        } else if (c == '$') {
+            ++i;
+            while (i < n && std::isdigit((unsigned char)text[i])) ++i;
+        } else {
+            std::size_t j = i;
+            while (j < n && !std::isspace((unsigned char)text[j]) &&
+                   text[j] != '{' && text[j] != '(' && text[j] != ')' && text[j] != ';')
+                ++j;
+            std::string_view tok = text.substr(i, j - i);
+            i = (j == i) ? i + 1 : j;
+
+            if (is_result(tok)) {
+                out.result = std::string(tok);
+                break;
+            }
+
+            // Move numbers: "12." and "12..." (possibly glued to the move)
+            std::size_t k = 0;
+            while (k < tok.size() && std::isdigit((unsigned char)tok[k])) ++k;
+            if (k < tok.size() && tok[k] == '.') {
+                while (k < tok.size() && tok[k] == '.') ++k;
+                tok.remove_prefix(k);
+            }
+            if (tok.empty()) continue;
+
+            if (!begin_moves()) return false;
+            if (max_plies > 0 && (int)out.moves.size() >= max_plies) break;
+
+            auto m = Parse::san(pos, tok);
+            if (!m) {
+                err = "Illegal or ambiguous move '" + std::string(tok) + "' at ply " +
+                      std::to_string(out.moves.size() + 1);
+                return false;
+            }
+            if (on_move) on_move(pos, *m);
+            if (!pos.make_move(*m, err)) return false;
+            out.moves.push_back(*m);
+        }
+    }
+
+    if (!begin_moves()) return false;
+
+    // A truncated parse never reaches the movetext result
+    if (out.result == "*") {
+        std::string r = out.tag("Result");
+        if (is_result(r)) out.result = r;
+    }
+    return true;
+}
+
+std::string Pgn::write(const PgnGame& game, const std::vector<std::string>& annotations) {
+    std::string out;
+    bool has_result_tag = false;
+    for (const auto& [name, value] : game.tags) {
+        std::string v;
+        for (char c : (name == "Result" ? game.result : value)) {
+            if (c == '"' || c == '\\') v += '\\';
+            v += c;
+        }
+        out += "[" + name + " \"" + v + "\"]\n";
+        has_result_tag |= (name == "Result");
+    }
+    if (!has_result_tag) out += "[Result \"" + game.result + "\"]\n";
+    out += "\n";
+
+    std::string line;
+    auto emit = [&](const std::string& tok) {
+        if (!line.empty() && line.size() + 1 + tok.size() > 80) {
+            out += line + "\n";
+            line.clear();
+        }
+        if (!line.empty()) line += ' ';
+        line += tok;
+    };
+
+    Position pos = game.start;
+    int number = 1;
+    bool need_number = true;   // after an annotation black's move is numbered again
+    std::string err;
+    for (std::size_t i = 0; i < game.moves.size(); ++i) {
+        const bool white = (pos.side_to_move() == Color::White);
+        if (white) emit(std::to_string(number) + ".");
+        else if (need_number) emit(std::to_string(number) + "...");
+
+        emit(Render::move_san(pos, game.moves[i]));
+        need_number = false;
+        if (i < annotations.size() && !annotations[i].empty()) {
+            emit(annotations[i]);
+            need_number = true;
+        }
+
+        if (!pos.make_move(game.moves[i], err)) break;
+        if (!white) ++number;
+    }
+    emit(game.result);
+    out += line + "\n";
+    return out;
+}
+
+} // namespace chess
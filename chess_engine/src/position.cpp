@@ -134,7 +134,7 @@ bool Position::make_move(const Move& m, std::string& err) {
 
     //  --- Update castling rights ---
     {
-        auto clear = [&](uint8_t flags) { cr_ = (uint8_t)(cr_ & ~flags); };
+        auto clear = [&](uint8_t flags) { set_castling_rights((uint8_t)(cr_ & ~flags)); };
 
         // King moved (including castling)
         if (moving == Piece::WK) clear(CR_WK | CR_WQ);
@@ -161,18 +161,21 @@ bool Position::make_move(const Move& m, std::string& err) {
         }
     }
 
+    halfmove_ = (is_pawn || captured != Piece::Empty) ? 0 : (uint16_t)(halfmove_ + 1);
+
     // ---- Update en passant target square ----
     // Set only if a pawn moved two squares; otherwise clear.
-    ep_ = -1;
+    set_ep_square(-1);
     if (moving == Piece::WP || moving == Piece::BP) {
         int dr = rank_of(m.to) - rank_of(m.from);
         int dir = (moving == Piece::WP) ? +1 : -1;
         if (dr == 2 * dir) {
-            ep_ = make_sq(file_of(m.from), rank_of(m.from) + dir);
+            set_ep_square(make_sq(file_of(m.from), rank_of(m.from) + dir));
         }
     }
 
-    stm_ = other(stm_);
+    if (stm_ == Color::Black) ++fullmove_;
+    set_side_to_move(other(stm_));
     return true;
 }
 
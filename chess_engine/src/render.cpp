@@ -1,4 +1,7 @@
 #include "render.hpp"
+#include "movegen.hpp"
+#include "rules.hpp"
+#include <cctype>
 #include <sstream>
 
 namespace chess {
@@ -21,6 +24,138 @@ char Render::piece_char(Piece p) {
     }
 }
 
+std::string Render::move_uci(const Move& m) {
+    std::string s;
+    s += char('a' + file_of(m.from));
+    s += char('1' + rank_of(m.from));
+    s += char('a' + file_of(m.to));
+    s += char('1' + rank_of(m.to));
+    switch (m.promo) {
+        case PROMO_Q: s += 'q'; break;
+        case PROMO_R: s += 'r'; break;
+        case PROMO_B: s += 'b'; break;
+        case PROMO_N: s += 'n'; break;
+        default: break;
+    }
+    return s;
+}
+
+std::string Render::move_san(const Position& pos, const Move& m) {
+    const Piece p = pos.at(m.from);
+    const char kind = (char)std::toupper((unsigned char)piece_char(p));
+    std::string s;
+
+    if (Rules::is_castle_move(pos, m)) {
+        s = (file_of(m.to) == 6) ? "O-O" : "O-O-O";
+    } else {
+        const bool capture = !is_empty(pos.at(m.to)) ||
+                             (kind == 'P' && file_of(m.from) != file_of(m.to));
+        if (kind == 'P') {
+            if (capture) s += char('a' + file_of(m.from));
+        } else {
+            s += kind;
+
+            // Name the file, else the rank, else both, when another piece
+            // of the same kind could also go there
+            MoveList legal;
+            MoveGen::generate_legal(pos, legal);
+            bool clash = false, same_file = false, same_rank = false;
+            for (int i = 0; i < legal.size; ++i) {
+                const Move& o = legal.moves[i];
+                if (o.to != m.to || o.from == m.from || pos.at(o.from) != p) continue;
+                clash = true;
+                if (file_of(o.from) == file_of(m.from)) same_file = true;
+                if (rank_of(o.from) == rank_of(m.from)) same_rank = true;
+            }
+            if (clash) {
+                if (!same_file) s += char('a' + file_of(m.from));
+                else if (!same_rank) s += char('1' + rank_of(m.from));
+                else { s += char('a' + file_of(m.from)); s += char('1' + rank_of(m.from)); }
+            }
+        }
+        if (capture) s += 'x';
+        s += char('a' + file_of(m.to));
+        s += char('1' + rank_of(m.to));
+
+        switch (m.promo) {
+            case PROMO_Q: s += "=Q"; break;
+            case PROMO_R: s += "=R"; break;
+            case PROMO_B: s += "=B"; break;
+            case PROMO_N: s += "=N"; break;
+            default: break;
+        }
+    }
+
+    Position next = pos;
+    std::string err;
+    if (next.make_move(m, err) && Rules::in_check(next, next.side_to_move())) {
+        s += MoveGen::has_any_legal_move(next) ? '+' : '#';
+    }
+    return s;
+}
+
+static char* put_number(char* p, int n) {
+    char tmp[8];
+    int len = 0;
+    do {
+        tmp[len++] = (char)('0' + n % 10);
+        n /= 10;
+    } while (n > 0);
+    while (len > 0) *p++ = tmp[--len];
+    return p;
+}
+
+std::size_t Render::fen(const Position& pos, char* buf) {
+    char* p = buf;
+    for (int r = 7; r >= 0; --r) {
+        int empty = 0;
+        for (int f = 0; f < 8; ++f) {
+            Piece pc = pos.at(make_sq(f, r));
+            if (is_empty(pc)) {
+                ++empty;
+                continue;
+            }
+            if (empty) *p++ = (char)('0' + empty);
+            empty = 0;
+            *p++ = piece_char(pc);
+        }
+        if (empty) *p++ = (char)('0' + empty);
+        if (r > 0) *p++ = '/';
+    }
+
+    *p++ = ' ';
+    *p++ = (pos.side_to_move() == Color::White) ? 'w' : 'b';
+
+    *p++ = ' ';
+    const uint8_t cr = pos.castling_rights();
+    if (cr == CR_NONE) *p++ = '-';
+    if (cr & CR_WK) *p++ = 'K';
+    if (cr & CR_WQ) *p++ = 'Q';
+    if (cr & CR_BK) *p++ = 'k';
+    if (cr & CR_BQ) *p++ = 'q';
+
+    *p++ = ' ';
+    const int ep = pos.ep_square();
+    if (ep == -1) {
+        *p++ = '-';
+    } else {
+        *p++ = (char)('a' + file_of(ep));
+        *p++ = (char)('1' + rank_of(ep));
+    }
+
+    *p++ = ' ';
+    p = put_number(p, pos.halfmove_clock());
+    *p++ = ' ';
+    p = put_number(p, pos.fullmove_number());
+    *p = '\0';
+    return (std::size_t)(p - buf);
+}
+
+std::string Render::fen(const Position& pos) {
+    char buf[FEN_MAX];
+    return std::string(buf, fen(pos, buf));
+}
+
 std::string Render::board_ascii(const Position& pos) {
     std::ostringstream out;
 
@@ -146,14 +146,15 @@ bool Rules::pseudo_king(const Position& pos, Piece p, int from, int to, std::str
     return true;
 }
 
-bool Rules::pseudo_pawn(const Position& pos, Piece p, const Move& m, std::string& err) {
+template <Color Us>
+bool Rules::pseudo_pawn(const Position& pos, const Move& m, std::string& err) {
+    using T = ColorTraits<Us>;
     const int from = m.from;
     const int to   = m.to;
 
-    const bool white = is_white(p);
-    const int dir = white ? +1 : -1;
-    const int start_rank = white ? 1 : 6;
-    const int last_rank  = white ? 7 : 0;
+    constexpr int dir = T::forward;
+    constexpr int start_rank = T::start_rank;
+    constexpr int last_rank  = T::last_rank;
 
     // --- Promotion validation ---
     const bool promotes = (rank_of(to) == last_rank);
@@ -197,7 +198,7 @@ bool Rules::pseudo_pawn(const Position& pos, Piece p, const Move& m, std::string
     // Diagonal capture (including en passant)
     if (std::abs(f) == 1 && r == dir) {
         // normal capture
-        if (is_opponent(p, target)) return true;
+        if (ColorTraits<T::them>::owns(target)) return true;
 
         // en passant: target square empty, but equals ep square, and captured pawn exists behind
         if (is_empty(target) && pos.ep_square() == to) {
@@ -207,8 +208,7 @@ bool Rules::pseudo_pawn(const Position& pos, Piece p, const Move& m, std::string
             Piece cap = pos.at(cap_sq);
 
             // captured pawn must be opponent pawn
-            if (white && cap == Piece::BP) return true;
-            if (!white && cap == Piece::WP) return true;
+            if (cap == ColorTraits<T::them>::pawn) return true;
 
             err = "En passant square set but no capturable pawn found.";
             return false;
@@ -240,8 +240,8 @@ bool Rules::is_pseudo_legal(const Position& pos, const Move& m, std::string& err
 
     switch (moving) {
        
-        case Piece::WP:
-        case Piece::BP: return pseudo_pawn(pos, moving, m, err);
+        case Piece::WP: return pseudo_pawn<Color::White>(pos, m, err);
+        case Piece::BP: return pseudo_pawn<Color::Black>(pos, m, err);
 
         case Piece::WN:
         case Piece::BN: return pseudo_knight(pos, moving, m.from, m.to, err);
@@ -263,112 +263,141 @@ bool Rules::is_pseudo_legal(const Position& pos, const Move& m, std::string& err
             return false;
     }
 }
-int Rules::find_king(const Position& pos, Color who) {
-    Piece k = (who == Color::White) ? Piece::WK : Piece::BK;
+template <Color Who>
+int Rules::find_king(const Position& pos) {
     for (int sq = 0; sq < 64; ++sq) {
-        if (pos.at(sq) == k) return sq;
+        if (pos.at(sq) == ColorTraits<Who>::king) return sq;
     }
     return -1;
 }
 
 // --- Attack detection ---
+// Looks outward from sq: pawn and leaper squares first, then the rays.
 // NOTE: pawn attacks differ from pawn forward moves.
-static bool adjacent(int a, int b) {
-    int rd = std::abs(rank_of(b) - rank_of(a));
-    int fd = std::abs(file_of(b) - file_of(a));
-    return (rd <= 1 && fd <= 1) && !(rd == 0 && fd == 0);
-}
+template <Color By>
+bool Rules::is_square_attacked(const Position& pos, int sq) {
+    using T = ColorTraits<By>;
+    const int f = file_of(sq), r = rank_of(sq);
 
-static bool knight_attack(int from, int to) {
-    int r = std::abs(rank_of(to) - rank_of(from));
-    int f = std::abs(file_of(to) - file_of(from));
-    return (r == 2 && f == 1) || (r == 1 && f == 2);
-}
-bool Rules::is_square_attacked(const Position& pos, int sq, Color by) {
-    // Pawn attacks
-    // White pawns attack (file±1, rank+1). Black pawns attack (file±1, rank-1).
+    // Pawns attack diagonally forward, so attackers stand one rank behind sq
     {
-        int f = file_of(sq), r = rank_of(sq);
-        if (by == Color::White) {
-            // attackers are on r-1
-            int r_from = r - 1;
-            if (r_from >= 0) {
-                if (f - 1 >= 0 && pos.at(make_sq(f - 1, r_from)) == Piece::WP) return true;
-                if (f + 1 <  8 && pos.at(make_sq(f + 1, r_from)) == Piece::WP) return true;
-            }
-        } else {
-            // black attackers are on r+1
-            int r_from = r + 1;
-            if (r_from < 8) {
-                if (f - 1 >= 0 && pos.at(make_sq(f - 1, r_from)) == Piece::BP) return true;
-                if (f + 1 <  8 && pos.at(make_sq(f + 1, r_from)) == Piece::BP) return true;
-            }
+        const int r_from = r - T::forward;
+        if (r_from >= 0 && r_from < 8) {
+            if (f - 1 >= 0 && pos.at(make_sq(f - 1, r_from)) == T::pawn) return true;
+            if (f + 1 <  8 && pos.at(make_sq(f + 1, r_from)) == T::pawn) return true;
         }
     }
 
-    // Knight attacks
+    // Knights
     {
-        Piece n = (by == Color::White) ? Piece::WN : Piece::BN;
-        for (int from = 0; from < 64; ++from) {
-            if (pos.at(from) == n && knight_attack(from, sq)) return true;
+        static const int d[8][2] = {
+            {+1,+2},{+2,+1},{+2,-1},{+1,-2},
+            {-1,-2},{-2,-1},{-2,+1},{-1,+2}
+        };
+        for (auto& dd : d) {
+            int ff = f + dd[0], rr = r + dd[1];
+            if (ff >= 0 && ff < 8 && rr >= 0 && rr < 8 && pos.at(make_sq(ff, rr)) == T::knight) return true;
         }
     }
 
-    // King attacks (adjacent)
-    {
-        Piece k = (by == Color::White) ? Piece::WK : Piece::BK;
-        for (int from = 0; from < 64; ++from) {
-            if (pos.at(from) == k && adjacent(from, sq)) return true;
+    // King (adjacent)
+    for (int df = -1; df <= 1; ++df) {
+        for (int dr = -1; dr <= 1; ++dr) {
+            int ff = f + df, rr = r + dr;
+            if ((df || dr) && ff >= 0 && ff < 8 && rr >= 0 && rr < 8 && pos.at(make_sq(ff, rr)) == T::king) return true;
         }
     }
 
     // Sliding attacks: bishops/queens on diagonals, rooks/queens on lines
-    auto ray_hits = [&](int df_step, int dr_step, Piece a, Piece b) -> bool {
-        int f = file_of(sq) + df_step;
-        int r = rank_of(sq) + dr_step;
-        while (f >= 0 && f < 8 && r >= 0 && r < 8) {
-            Piece x = pos.at(make_sq(f, r));
-            if (!is_empty(x)) return (x == a || x == b);
-            f += df_step;
-            r += dr_step;
+    auto ray_hits = [&](int df_step, int dr_step, Piece slider) -> bool {
+        int ff = f + df_step;
+        int rr = r + dr_step;
+        while (ff >= 0 && ff < 8 && rr >= 0 && rr < 8) {
+            Piece x = pos.at(make_sq(ff, rr));
+            if (!is_empty(x)) return (x == slider || x == T::queen);
+            ff += df_step;
+            rr += dr_step;
         }
         return false;
     };
 
-    if (by == Color::White) {
-        // Diagonals: WB/WQ
-        if (ray_hits(+1,+1, Piece::WB, Piece::WQ)) return true;
-        if (ray_hits(-1,+1, Piece::WB, Piece::WQ)) return true;
-        if (ray_hits(+1,-1, Piece::WB, Piece::WQ)) return true;
-        if (ray_hits(-1,-1, Piece::WB, Piece::WQ)) return true;
-
-        // Straights: WR/WQ
-        if (ray_hits(+1, 0, Piece::WR, Piece::WQ)) return true;
-        if (ray_hits(-1, 0, Piece::WR, Piece::WQ)) return true;
-        if (ray_hits( 0,+1, Piece::WR, Piece::WQ)) return true;
-        if (ray_hits( 0,-1, Piece::WR, Piece::WQ)) return true;
-    } else {
-        // Diagonals: BB/BQ
-        if (ray_hits(+1,+1, Piece::BB, Piece::BQ)) return true;
-        if (ray_hits(-1,+1, Piece::BB, Piece::BQ)) return true;
-        if (ray_hits(+1,-1, Piece::BB, Piece::BQ)) return true;
-        if (ray_hits(-1,-1, Piece::BB, Piece::BQ)) return true;
+    return ray_hits(+1,+1, T::bishop) || ray_hits(-1,+1, T::bishop) ||
+           ray_hits(+1,-1, T::bishop) || ray_hits(-1,-1, T::bishop) ||
+           ray_hits(+1, 0, T::rook)   || ray_hits(-1, 0, T::rook)   ||
+           ray_hits( 0,+1, T::rook)   || ray_hits( 0,-1, T::rook);
+}
+
+template <Color Who>
+bool Rules::in_check(const Position& pos) {
+    int ksq = find_king<Who>(pos);
+    if (ksq < 0) return false; // or treat as invalid position
+    return is_square_attacked<ColorTraits<Who>::them>(pos, ksq);
+}
 
-        // Straights: BR/BQ
-        if (ray_hits(+1, 0, Piece::BR, Piece::BQ)) return true;
-        if (ray_hits(-1, 0, Piece::BR, Piece::BQ)) return true;
-        if (ray_hits( 0,+1, Piece::BR, Piece::BQ)) return true;
-        if (ray_hits( 0,-1, Piece::BR, Piece::BQ)) return true;
+template <Color By>
+int Rules::smallest_attacker(const std::array<Piece, 64>& board, int sq) {
+    using T = ColorTraits<By>;
+    const int f = file_of(sq), r = rank_of(sq);
+    auto on_board = [](int ff, int rr) { return ff >= 0 && ff < 8 && rr >= 0 && rr < 8; };
+
+    const int r_from = r - T::forward;
+    for (int df : {-1, +1}) {
+        if (on_board(f + df, r_from) && board[make_sq(f + df, r_from)] == T::pawn) return make_sq(f + df, r_from);
     }
 
-    return false;
+    static const int kn[8][2] = {
+        {+1,+2},{+2,+1},{+2,-1},{+1,-2},
+        {-1,-2},{-2,-1},{-2,+1},{-1,+2}
+    };
+    for (auto& d : kn) {
+        if (on_board(f + d[0], r + d[1]) && board[make_sq(f + d[0], r + d[1])] == T::knight) return make_sq(f + d[0], r + d[1]);
+    }
+
+    // First piece on each ray: diagonals 0..3, lines 4..7
+    static const int rays[8][2] = {
+        {+1,+1},{-1,+1},{+1,-1},{-1,-1},
+        {+1, 0},{-1, 0},{ 0,+1},{ 0,-1}
+    };
+    int first[8];
+    for (int i = 0; i < 8; ++i) {
+        first[i] = -1;
+        int ff = f + rays[i][0], rr = r + rays[i][1];
+        while (on_board(ff, rr)) {
+            int s = make_sq(ff, rr);
+            if (!is_empty(board[s])) { first[i] = s; break; }
+            ff += rays[i][0];
+            rr += rays[i][1];
+        }
+    }
+    for (int i = 0; i < 4; ++i) if (first[i] >= 0 && board[first[i]] == T::bishop) return first[i];
+    for (int i = 4; i < 8; ++i) if (first[i] >= 0 && board[first[i]] == T::rook) return first[i];
+    for (int i = 0; i < 8; ++i) if (first[i] >= 0 && board[first[i]] == T::queen) return first[i];
+
+    for (int df = -1; df <= 1; ++df) {
+        for (int dr = -1; dr <= 1; ++dr) {
+            if ((df || dr) && on_board(f + df, r + dr) && board[make_sq(f + df, r + dr)] == T::king) return make_sq(f + df, r + dr);
+        }
+    }
+    return -1;
 }
 
+int Rules::smallest_attacker(const std::array<Piece, 64>& board, int sq, Color by) {
+    return (by == Color::White) ? smallest_attacker<Color::White>(board, sq)
+                                : smallest_attacker<Color::Black>(board, sq);
+}
+
+template bool Rules::is_square_attacked<Color::White>(const Position&, int);
+template bool Rules::is_square_attacked<Color::Black>(const Position&, int);
+template bool Rules::in_check<Color::White>(const Position&);
+template bool Rules::in_check<Color::Black>(const Position&);
+
+bool Rules::is_square_attacked(const Position& pos, int sq, Color by) {
+    return (by == Color::White) ? is_square_attacked<Color::White>(pos, sq)
+                                : is_square_attacked<Color::Black>(pos, sq);
+}
 
 bool Rules::in_check(const Position& pos, Color who) {
-    int ksq = find_king(pos, who);
-    if (ksq < 0) return false; // or treat as invalid position
-    return is_square_attacked(pos, ksq, other(who));
+    return (who == Color::White) ? in_check<Color::White>(pos) : in_check<Color::Black>(pos);
 }
 
 bool Rules::is_castle_move(const Position& pos, const Move& m) {
@@ -387,63 +416,56 @@ bool Rules::castle_path_safe(const Position& pos, const Move& m, std::string& er
     err.clear();
 
     Piece k = pos.at(m.from);
-    if (!(k == Piece::WK || k == Piece::BK)) {
-        err = "Not a king castling move.";
-        return false;
-    }
+    if (k == Piece::WK) return castle_path_safe_for<Color::White>(pos, m, err);
+    if (k == Piece::BK) return castle_path_safe_for<Color::Black>(pos, m, err);
+    err = "Not a king castling move.";
+    return false;
+}
 
-    Color side = (k == Piece::WK) ? Color::White : Color::Black;
+template <Color Us>
+bool Rules::castle_path_safe_for(const Position& pos, const Move& m, std::string& err) {
+    using T = ColorTraits<Us>;
+    constexpr Color them = T::them;
+    constexpr bool white = (Us == Color::White);
+    constexpr int r = T::back_rank;
 
     // Must not be in check at start
-    if (Rules::in_check(pos, side)) {
+    if (in_check<Us>(pos)) {
         err = "Cannot castle while in check.";
         return false;
     }
 
-    int from = m.from;
-    int to   = m.to;
-
-    int r = rank_of(from);
-    int f_from = file_of(from);
-    int f_to   = file_of(to);
-
-    bool king_side = (f_to > f_from);
+    const int from = m.from;
+    const int to   = m.to;
+    const bool king_side = (file_of(to) > file_of(from));
 
-    // Determine squares the king passes through:
+    // Squares king goes through or lands on must not be attacked:
     // e1->g1 passes through f1; e1->c1 passes through d1
-    int through = make_sq(f_from + (king_side ? +1 : -1), r);
-
-    // Squares king goes through or lands on must not be attacked
-    if (Rules::is_square_attacked(pos, through, other(side))) {
+    const int through = make_sq(file_of(from) + (king_side ? +1 : -1), rank_of(from));
+    if (is_square_attacked<them>(pos, through)) {
         err = "Cannot castle through check.";
         return false;
     }
-    if (Rules::is_square_attacked(pos, to, other(side))) {
+    if (is_square_attacked<them>(pos, to)) {
         err = "Cannot castle into check.";
         return false;
     }
 
     // Also ensure rook exists and squares between are empty (defensive)
-    if (side == Color::White) {
-        if (king_side) {
-            if (!has_right(pos.castling_rights(), CR_WK)) { err = "No white king-side rights."; return false; }
-            if (pos.at(make_sq(5,0)) != Piece::Empty || pos.at(make_sq(6,0)) != Piece::Empty) { err = "Squares not empty."; return false; }
-            if (pos.at(make_sq(7,0)) != Piece::WR) { err = "Rook missing on h1."; return false; }
-        } else {
-            if (!has_right(pos.castling_rights(), CR_WQ)) { err = "No white queen-side rights."; return false; }
-            if (pos.at(make_sq(3,0)) != Piece::Empty || pos.at(make_sq(2,0)) != Piece::Empty || pos.at(make_sq(1,0)) != Piece::Empty) { err = "Squares not empty."; return false; }
-            if (pos.at(make_sq(0,0)) != Piece::WR) { err = "Rook missing on a1."; return false; }
+    if (king_side) {
+        if (!has_right(pos.castling_rights(), white ? CR_WK : CR_BK)) {
+            err = white ? "No white king-side rights." : "No black king-side rights.";
+            return false;
         }
+        if (pos.at(make_sq(5, r)) != Piece::Empty || pos.at(make_sq(6, r)) != Piece::Empty) { err = "Squares not empty."; return false; }
+        if (pos.at(make_sq(7, r)) != T::rook) { err = white ? "Rook missing on h1." : "Rook missing on h8."; return false; }
     } else {
-        if (king_side) {
-            if (!has_right(pos.castling_rights(), CR_BK)) { err = "No black king-side rights."; return false; }
-            if (pos.at(make_sq(5,7)) != Piece::Empty || pos.at(make_sq(6,7)) != Piece::Empty) { err = "Squares not empty."; return false; }
-            if (pos.at(make_sq(7,7)) != Piece::BR) { err = "Rook missing on h8."; return false; }
-        } else {
-            if (!has_right(pos.castling_rights(), CR_BQ)) { err = "No black queen-side rights."; return false; }
-            if (pos.at(make_sq(3,7)) != Piece::Empty || pos.at(make_sq(2,7)) != Piece::Empty || pos.at(make_sq(1,7)) != Piece::Empty) { err = "Squares not empty."; return false; }
-            if (pos.at(make_sq(0,7)) != Piece::BR) { err = "Rook missing on a8."; return false; }
+        if (!has_right(pos.castling_rights(), white ? CR_WQ : CR_BQ)) {
+            err = white ? "No white queen-side rights." : "No black queen-side rights.";
+            return false;
         }
+        if (pos.at(make_sq(3, r)) != Piece::Empty || pos.at(make_sq(2, r)) != Piece::Empty || pos.at(make_sq(1, r)) != Piece::Empty) { err = "Squares not empty."; return false; }
+        if (pos.at(make_sq(0, r)) != T::rook) { err = white ? "Rook missing on a1." : "Rook missing on a8."; return false; }
     }
 
     return true;
@@ -1,97 +1,685 @@
-#include "search.hpp"
-#include "movegen.hpp"
-#include "eval.hpp"
-#include "rules.hpp"
-#include <limits>
-
-namespace chess {
-
-static int alphabeta(Position& pos, int depth, int alpha, int beta) {
-    if (depth == 0) {
-        return Eval::evaluate(pos);
-    }
-
-    MoveList moves;
-    MoveGen::generate_legal(pos, moves);
-
-    // Terminal positions
-    if (moves.size == 0) {
-        if (Rules::in_check(pos, pos.side_to_move())) {
-            // Checkmate
-            return (pos.side_to_move() == Color::White)
-                ? -100000
-                : +100000;
-        }
-        // Stalemate
-        return 0;
-    }
-
-    bool maximizing = (pos.side_to_move() == Color::White);
-
-    if (maximizing) {
-        int best = std::numeric_limits<int>::min();
-        for (int i = 0; i < moves.size; ++i) {
-            Position child = pos;
-            std::string err;
-            child.make_move(moves.moves[i], err);
-
-            int score = alphabeta(child, depth - 1, alpha, beta);
-            best = std::max(best, score);
-            alpha = std::max(alpha, score);
-            if (beta <= alpha) break;
-        }
-        return best;
-    } else {
-        int best = std::numeric_limits<int>::max();
-        for (int i = 0; i < moves.size; ++i) {
-            Position child = pos;
-            std::string err;
-            child.make_move(moves.moves[i], err);
-
-            int score = alphabeta(child, depth - 1, alpha, beta);
-            best = std::min(best, score);
-            beta = std::min(beta, score);
-            if (beta <= alpha) break;
-        }
-        return best;
-    }
-}
-
-SearchResult Search::minimax(Position& pos, int depth) {
-    MoveList moves;
-    MoveGen::generate_legal(pos, moves);
-
-    SearchResult res;
-    res.score = (pos.side_to_move() == Color::White)
-        ? std::numeric_limits<int>::min()
-        : std::numeric_limits<int>::max();
-
-    for (int i = 0; i < moves.size; ++i) {
-        Position child = pos;
-        std::string err;
-        child.make_move(moves.moves[i], err);
-
-        int score = alphabeta(
-            child,
-            depth - 1,
-            std::numeric_limits<int>::min(),
-            std::numeric_limits<int>::max()
-        );
-
-        if (pos.side_to_move() == Color::White) {
-            if (score > res.score) {
-                res.score = score;
-                res.best = moves.moves[i];
-            }
-        } else {
-            if (score < res.score) {
-                res.score = score;
-                res.best = moves.moves[i];
-            }
-        }
-    }
-
-    return res;
-}
-
-}
+#include "search.hpp"
+#include "movegen.hpp"
+#include "eval.hpp"
+#include "gamestate.hpp"
+#include "rules.hpp"
+#include "see.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace chess {
+
+namespace {
+
+constexpr int INF  = 1000000;
+constexpr int MATE = MATE_SCORE;
+
+// Move ordering buckets; within a bucket the finer score decides.
+constexpr int ORDER_PV      = 3000000;
+constexpr int ORDER_TT      = 2000000;
+constexpr int ORDER_CAPTURE = 1000000;
+constexpr int ORDER_KILLER1 = 900000;
+constexpr int ORDER_KILLER2 = 800000;
+constexpr int HISTORY_MAX   = 500000;
+constexpr int ORDER_BAD_CAPTURE = -1000000;   // after all quiet moves
+
+// reductions[depth][move number], log-log shaped.
+struct ReductionTable {
+    std::array<std::array<int, 256>, MAX_PLY> r{};
+
+    ReductionTable() {
+        for (int d = 1; d < MAX_PLY; ++d) {
+            for (int m = 1; m < 256; ++m) {
+                r[d][m] = int(0.75 + std::log(double(d)) * std::log(double(m)) / 2.25);
+            }
+        }
+    }
+};
+
+const ReductionTable REDUCTIONS;
+
+// Static eval from the side to move's point of view (negamax convention).
+int evaluate_stm(const Position& pos) {
+    int e = Eval::evaluate(pos);
+    return (pos.side_to_move() == Color::White) ? e : -e;
+}
+
+// Zugzwang guard: with only king and pawns a pass may be the best "move".
+bool has_non_pawn_material(const Position& pos, Color side) {
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p) || p == Piece::WP || p == Piece::BP || p == Piece::WK || p == Piece::BK) continue;
+        if ((side == Color::White) == is_white(p)) return true;
+    }
+    return false;
+}
+
+// The piece a move takes. En passant lands on an empty square and takes
+// the pawn beside it.
+Piece captured_piece(const Position& pos, const Move& m) {
+    const Piece mover = pos.at(m.from);
+    if ((mover == Piece::WP || mover == Piece::BP) && m.to == pos.ep_square() &&
+        file_of(m.from) != file_of(m.to)) {
+        return mover == Piece::WP ? Piece::BP : Piece::WP;
+    }
+    return pos.at(m.to);
+}
+
+// Victims and attackers are valued with SEE's table, so ordering and the
+// losing-capture test below agree on what a piece is worth. The king's
+// 20000 still leaves king captures above every quiet move.
+int mvv_lva(const Position& pos, const Move& m) {
+    int s = 0;
+    Piece victim = captured_piece(pos, m);
+    if (!is_empty(victim)) s = 10000 + 10 * See::piece_value(victim) - See::piece_value(pos.at(m.from)) / 10;
+    if (m.promo == PROMO_Q) s += 9000;
+    return s;
+}
+
+// Captures that lose material by exchange evaluation. Taking with a piece
+// worth no more than the victim can't lose, so SEE only runs otherwise.
+bool losing_capture(const Position& pos, const Move& m) {
+    if (See::piece_value(pos.at(m.from)) <= See::piece_value(captured_piece(pos, m))) return false;
+    return !See::ge(pos, m, 0);
+}
+
+// Mate scores are stored relative to the node, not the root.
+int score_to_tt(int s, int ply) {
+    if (s >= MATE - MAX_PLY) return s + ply;
+    if (s <= -(MATE - MAX_PLY)) return s - ply;
+    return s;
+}
+
+int score_from_tt(int s, int ply) {
+    if (s >= MATE - MAX_PLY) return s - ply;
+    if (s <= -(MATE - MAX_PLY)) return s + ply;
+    return s;
+}
+
+void pick_next(MoveList& moves, std::array<int, MoveList::CAPACITY>& scores, int i) {
+    int best = i;
+    for (int j = i + 1; j < moves.size; ++j) {
+        if (scores[j] > scores[best]) best = j;
+    }
+    if (best != i) {
+        std::swap(moves.moves[i], moves.moves[best]);
+        std::swap(scores[i], scores[best]);
+    }
+}
+
+} // namespace
+
+// Counter updates vanish entirely when statistics are compiled out.
+#define SEARCH_STAT(expr) do { if constexpr (SearchStats::enabled) { expr; } } while (0)
+
+double SearchStats::branching_factor() const {
+    if (iterations.size() < 2 || iterations.front().nodes == 0) return 0.0;
+    double ratio = double(iterations.back().nodes) / double(iterations.front().nodes);
+    return std::pow(ratio, 1.0 / double(iterations.size() - 1));
+}
+
+void SearchStats::merge(const SearchStats& o) {
+    nodes += o.nodes;
+    qnodes += o.qnodes;
+    beta_cutoffs += o.beta_cutoffs;
+    first_move_cutoffs += o.first_move_cutoffs;
+    tt_probes += o.tt_probes;
+    tt_hits += o.tt_hits;
+    tt_cutoffs += o.tt_cutoffs;
+    seldepth = std::max(seldepth, o.seldepth);
+}
+
+const std::vector<SearchParams::Field>& SearchParams::fields() {
+    static const std::vector<Field> f = {
+        {"aspiration_window",  &SearchParams::aspiration_window},
+        {"null_min_depth",     &SearchParams::null_min_depth},
+        {"null_r_base",        &SearchParams::null_r_base},
+        {"null_r_div",         &SearchParams::null_r_div},
+        {"lmr_min_depth",      &SearchParams::lmr_min_depth},
+        {"lmr_min_move",       &SearchParams::lmr_min_move},
+        {"rfp_max_depth",      &SearchParams::rfp_max_depth},
+        {"rfp_margin",         &SearchParams::rfp_margin},
+        {"futility_max_depth", &SearchParams::futility_max_depth},
+        {"futility_base",      &SearchParams::futility_base},
+        {"futility_per_depth", &SearchParams::futility_per_depth},
+        {"razor_max_depth",    &SearchParams::razor_max_depth},
+        {"razor_margin",       &SearchParams::razor_margin},
+        {"lmp_max_depth",      &SearchParams::lmp_max_depth},
+        {"lmp_base",           &SearchParams::lmp_base},
+    };
+    return f;
+}
+
+bool SearchParams::set(const std::string& name, int value) {
+    for (const auto& [n, field] : fields()) {
+        if (name == n) {
+            this->*field = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+Searcher::Searcher(TranspositionTable& tt, const SearchParams& params)
+    : tt_(tt), params_(params), stack_(new Frame[MAX_PLY + 1]) {}
+
+void Searcher::clear() {
+    for (auto& k : killers_) k = {};
+    for (auto& h : history_) h.fill(0);
+}
+
+void Searcher::start_clock(const Position& pos, const SearchLimits& limits) {
+    start_ = clock_start_ = Clock::now();
+    soft_ms_ = hard_ms_ = 0;
+    node_limit_ = limits.nodes;
+    pondering_ = limits.ponder;
+
+    if (limits.infinite) return;
+
+    if (limits.movetime_ms > 0) {
+        soft_ms_ = hard_ms_ = limits.movetime_ms;
+        return;
+    }
+
+    bool white = (pos.side_to_move() == Color::White);
+    int64_t time = white ? limits.wtime_ms : limits.btime_ms;
+    int64_t inc  = white ? limits.winc_ms  : limits.binc_ms;
+    if (time <= 0) return;
+
+    // Spend an even share of the clock plus most of the increment; stop
+    // deepening past 60% of that, never use more than the clock minus a buffer.
+    int64_t mtg = (limits.movestogo > 0) ? std::min(limits.movestogo, 40) : 30;
+    int64_t optimum = time / mtg + inc * 3 / 4;
+    hard_ms_ = std::max<int64_t>(1, std::min(optimum * 5 / 2, time - 50));
+    soft_ms_ = std::max<int64_t>(1, std::min(optimum * 6 / 10, hard_ms_));
+}
+
+int64_t Searcher::elapsed_ms() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_).count();
+}
+
+int64_t Searcher::clock_ms() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - clock_start_).count();
+}
+
+// True while a ponder search has not been converted yet. On the ponder hit
+// the clock restarts: our own time only runs from that moment.
+bool Searcher::pondering() {
+    if (pondering_ && ponder_flag_ && !ponder_flag_->load(std::memory_order_relaxed)) {
+        pondering_ = false;
+        clock_start_ = Clock::now();
+    }
+    return pondering_;
+}
+
+// Called every few thousand nodes: honor stop requests and limits, and
+// send a progress line about once a second.
+void Searcher::poll() {
+    if (external_stop_ && external_stop_->load(std::memory_order_relaxed)) stopped_ = true;
+    if (node_limit_ && nodes() >= node_limit_) stopped_ = true;
+
+    if (!pondering() && hard_ms_ && clock_ms() >= hard_ms_) stopped_ = true;
+
+    int64_t t = elapsed_ms();
+    if (on_info_ && t - last_report_ms_ >= 1000) {
+        last_report_ms_ = t;
+        SearchInfo info;
+        info.seldepth = seldepth_;
+        info.nodes = nodes();
+        info.time_ms = t;
+        (*on_info_)(info);
+    }
+}
+
+// PV move first, then the TT move, captures/promotions by MVV-LVA, killers,
+// the remaining quiet moves by history, and captures that lose material
+// by SEE last.
+void Searcher::score_moves(const Position& pos, const MoveList& moves, int ply, const Move& tt_move,
+                           std::array<int, MoveList::CAPACITY>& scores) {
+    bool pv_found = false;
+    for (int i = 0; i < moves.size; ++i) {
+        const Move& m = moves.moves[i];
+        int tactical = mvv_lva(pos, m);
+        if (follow_pv_ && ply < (int)prev_pv_.size() && m == prev_pv_[ply]) {
+            scores[i] = ORDER_PV;
+            pv_found = true;
+        } else if (m == tt_move) {
+            scores[i] = ORDER_TT;
+        } else if (tactical > 0) {
+            scores[i] = (losing_capture(pos, m) ? ORDER_BAD_CAPTURE : ORDER_CAPTURE) + tactical;
+        } else if (m == killers_[ply][0]) {
+            scores[i] = ORDER_KILLER1;
+        } else if (m == killers_[ply][1]) {
+            scores[i] = ORDER_KILLER2;
+        } else {
+            scores[i] = history_[m.from][m.to];
+        }
+    }
+    if (!pv_found) follow_pv_ = false;
+}
+
+void Searcher::update_quiet_stats(const Move& m, int ply, int depth) {
+    if (!(killers_[ply][0] == m)) {
+        killers_[ply][1] = killers_[ply][0];
+        killers_[ply][0] = m;
+    }
+
+    int& h = history_[m.from][m.to];
+    h += depth * depth;
+    if (h > HISTORY_MAX) {
+        for (auto& row : history_)
+            for (int& x : row) x /= 2;
+    }
+}
+
+// Captures and promotions only (all evasions when in check), so leaf
+// scores are taken from quiet positions.
+int Searcher::quiescence(Position& pos, int ply, int alpha, int beta) {
+    pv_len_[ply] = 0;
+    seldepth_ = std::max(seldepth_, ply);
+
+    if ((nodes_.fetch_add(1, std::memory_order_relaxed) & 2047) == 0) poll();
+    SEARCH_STAT(++stats_.qnodes);
+    if (stopped_) return 0;
+
+    const bool in_check = Rules::in_check(pos, pos.side_to_move());
+
+    int best = -INF;
+    if (!in_check) {
+        best = evaluate_stm(pos);
+        if (best >= beta || ply >= MAX_PLY - 1) return best;
+        alpha = std::max(alpha, best);
+    } else if (ply >= MAX_PLY - 1) {
+        return evaluate_stm(pos);
+    }
+
+    Frame& frame = stack_[ply];
+    MoveList& moves = frame.moves;
+    auto& scores = frame.scores;
+    Position& child = frame.child;
+
+    MoveGen::generate_legal(pos, moves);
+    if (moves.size == 0) {
+        return in_check ? -MATE + ply : 0;
+    }
+
+    for (int i = 0; i < moves.size; ++i) scores[i] = mvv_lva(pos, moves.moves[i]);
+
+    for (int i = 0; i < moves.size; ++i) {
+        pick_next(moves, scores, i);
+        if (!in_check && scores[i] == 0) break;   // only quiet moves left
+        if (!in_check && losing_capture(pos, moves.moves[i])) continue;
+
+        child = pos;
+        std::string err;
+        child.make_move(moves.moves[i], err);
+
+        int score = -quiescence(child, ply + 1, -beta, -alpha);
+        if (stopped_) return 0;
+
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) break;
+            }
+        }
+    }
+    return best;
+}
+
+// Only positions with the same side to move since the last irreversible
+// move can match.
+bool Searcher::is_repetition(const Position& pos, int ply) const {
+    const int idx = root_ + ply;
+    const int reach = std::min(pos.halfmove_clock(), idx);
+    for (int k = 2; k <= reach; k += 2) {
+        if (path_[idx - k] == pos.key()) return true;
+    }
+    return false;
+}
+
+// Fail-soft negamax PVS. Scores are relative to the side to move.
+int Searcher::alphabeta(Position& pos, int depth, int ply, int alpha, int beta, bool allow_null) {
+    pv_len_[ply] = 0;
+
+    if (depth <= 0) {
+        return quiescence(pos, ply, alpha, beta);
+    }
+
+    if ((nodes_.fetch_add(1, std::memory_order_relaxed) & 2047) == 0) poll();
+    if (stopped_) return 0;
+
+    if (ply >= MAX_PLY - 1) {
+        return evaluate_stm(pos);
+    }
+
+    // Draws by repetition or the fifty-move rule end the line at once. A
+    // repetition inside the tree counts the same as a threefold: the side
+    // that could avoid it will, so it is worth a draw either way.
+    path_[root_ + ply] = pos.key();
+    if (ply > 0) {
+        if (is_repetition(pos, ply)) return 0;
+        if (GameState::is_fifty_move_draw(pos)) return 0;
+    }
+
+    // Endgame tables: exact result, mate distance counted from the root
+    if (tb_ && ply > 0) {
+        if (auto r = tb_->probe(pos)) {
+            if (r->wdl == Wdl::Draw) return 0;
+            int dist = ply + r->dtm;
+            int s = (dist < MAX_PLY) ? MATE - dist : MATE - MAX_PLY - 1;
+            return (r->wdl == Wdl::Win) ? s : -s;
+        }
+    }
+
+    const SearchParams& sp = params_;
+    const bool pv_node  = (beta - alpha > 1);
+    const int alpha_orig = alpha;
+
+    // Transposition table: cut at non-PV nodes, otherwise just order
+    TTEntry tte;
+    Move tt_move;
+    SEARCH_STAT(++stats_.tt_probes);
+    if (tt_.probe(pos.key(), tte)) {
+        SEARCH_STAT(++stats_.tt_hits);
+        tt_move = tte.move;
+        int s = score_from_tt(tte.score, ply);
+        if (!pv_node && tte.depth >= depth) {
+            if (tte.bound == BOUND_EXACT ||
+                (tte.bound == BOUND_LOWER && s >= beta) ||
+                (tte.bound == BOUND_UPPER && s <= alpha)) {
+                SEARCH_STAT(++stats_.tt_cutoffs);
+                return s;
+            }
+        }
+    }
+
+    const Color us      = pos.side_to_move();
+    const bool in_check = Rules::in_check(pos, us);
+    const int static_eval = in_check ? -INF : evaluate_stm(pos);
+
+    // Frontier pruning on the static eval; never in check or at PV nodes,
+    // and never when a mate score is at stake.
+    if (!pv_node && !in_check && !is_mate_score(beta)) {
+        // Reverse futility: far enough above beta that nothing will bring it back
+        if (depth <= sp.rfp_max_depth && static_eval - sp.rfp_margin * depth >= beta) {
+            return static_eval;
+        }
+
+        // Razoring: hopeless at the frontier, let quiescence confirm it
+        if (depth <= sp.razor_max_depth && static_eval + sp.razor_margin * depth < alpha) {
+            int score = quiescence(pos, ply, alpha, beta);
+            if (depth == 1 || score <= alpha) return score;
+        }
+    }
+
+    // Null-move pruning: if passing still fails high, a real move will too.
+    if (allow_null && !pv_node && !in_check && ply > 0 && depth >= sp.null_min_depth &&
+        has_non_pawn_material(pos, us) && static_eval >= beta) {
+        Position& child = stack_[ply].child;
+        child = pos;
+        child.make_null_move();
+
+        int r = sp.null_r_base + depth / sp.null_r_div;
+        int score = -alphabeta(child, depth - 1 - r, ply + 1, -beta, -beta + 1, false);
+        if (stopped_) return 0;
+        if (score >= beta) {
+            // Don't trust unproven mates from a pass
+            return is_mate_score(score) ? beta : score;
+        }
+    }
+
+    Frame& frame = stack_[ply];
+    MoveList& moves = frame.moves;
+    auto& scores = frame.scores;
+    Position& child = frame.child;
+
+    MoveGen::generate_legal(pos, moves);
+
+    // Terminal positions: prefer the shortest mate
+    if (moves.size == 0) {
+        return in_check ? -MATE + ply : 0;
+    }
+
+    score_moves(pos, moves, ply, tt_move, scores);
+
+    const bool can_prune = !pv_node && !in_check;
+    const int futility_value = static_eval + sp.futility_base + sp.futility_per_depth * depth;
+    const bool futile = can_prune && depth <= sp.futility_max_depth && futility_value <= alpha;
+    const int lmp_count = sp.lmp_base + depth * depth;
+
+    int best = -INF;
+    Move best_move;
+    int excluded = 0;
+    for (int next = 0; next < moves.size; ++next) {
+        pick_next(moves, scores, next);
+        const Move& m = moves.moves[next];
+        if (ply == 0 && std::find(root_excluded_.begin(), root_excluded_.end(), m) != root_excluded_.end()) {
+            ++excluded;
+            continue;
+        }
+        const int i = next - excluded;   // position among the moves searched here
+        const bool quiet = is_empty(captured_piece(pos, m)) && m.promo == PROMO_NONE;
+
+        child = pos;
+        std::string err;
+        child.make_move(m, err);
+        const bool gives_check = Rules::in_check(child, child.side_to_move());
+
+        // Shallow quiet moves that cannot lift the eval to alpha, or that come
+        // this late in the ordering, are skipped once something was searched.
+        if (can_prune && quiet && !gives_check && i > 0 && !is_mate_score(best)) {
+            if (futile) {
+                best = std::max(best, futility_value);
+                continue;
+            }
+            if (depth <= sp.lmp_max_depth && i >= lmp_count) continue;
+        }
+
+        int score;
+        if (i == 0) {
+            score = -alphabeta(child, depth - 1, ply + 1, -beta, -alpha, true);
+        } else {
+            // Late quiet moves are unlikely to matter: scout them shallower
+            // and only pay for full depth if the reduced search fails high.
+            int r = 0;
+            if (depth >= sp.lmr_min_depth && i >= sp.lmr_min_move && quiet && !in_check && !gives_check) {
+                r = REDUCTIONS.r[std::min(depth, MAX_PLY - 1)][std::min(i, 255)];
+                if (pv_node) r = std::max(0, r - 1);
+                r = std::min(r, depth - 2);
+            }
+
+            // Scout with a null window; only a move that might beat alpha
+            // inside (alpha, beta) needs the full re-search.
+            score = -alphabeta(child, depth - 1 - r, ply + 1, -alpha - 1, -alpha, true);
+            if (r > 0 && score > alpha) {
+                score = -alphabeta(child, depth - 1, ply + 1, -alpha - 1, -alpha, true);
+            }
+            if (score > alpha && score < beta) {
+                score = -alphabeta(child, depth - 1, ply + 1, -beta, -alpha, true);
+            }
+        }
+        if (stopped_) return 0;
+
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                best_move = m;
+
+                pv_[ply][0] = m;
+                for (int j = 0; j < pv_len_[ply + 1]; ++j) pv_[ply][j + 1] = pv_[ply + 1][j];
+                pv_len_[ply] = pv_len_[ply + 1] + 1;
+
+                if (alpha >= beta) {
+                    SEARCH_STAT(++stats_.beta_cutoffs; if (i == 0) ++stats_.first_move_cutoffs);
+                    if (quiet) update_quiet_stats(m, ply, depth);
+                    break;
+                }
+            }
+        }
+    }
+
+    // A root searched without some of its moves has no true score to store
+    if (excluded == 0) {
+        Bound bound = (best >= beta) ? BOUND_LOWER : (best > alpha_orig ? BOUND_EXACT : BOUND_UPPER);
+        tt_.store(pos.key(), best_move, score_to_tt(best, ply), depth, bound);
+    }
+    return best;
+}
+
+SearchResult Searcher::search(const Position& root, const SearchLimits& limits, const InfoCallback& on_info) {
+    start_clock(root, limits);
+    reset_nodes();
+    seldepth_ = 0;
+    stopped_ = false;
+    last_report_ms_ = 0;
+    on_info_ = on_info ? &on_info : nullptr;
+    prev_pv_.clear();
+    stats_ = SearchStats{};
+    path_ = game_keys_;
+    root_ = (int)path_.size();
+    path_.resize(path_.size() + MAX_PLY + 1);
+
+    SearchResult res;
+    Position pos = root;
+    const int sign = (pos.side_to_move() == Color::White) ? 1 : -1;
+
+    MoveList moves;
+    MoveGen::generate_legal(pos, moves);
+    if (moves.size == 0) {
+        res.score = Rules::in_check(pos, pos.side_to_move()) ? -sign * MATE : 0;
+        on_info_ = nullptr;
+        return res;
+    }
+
+    // Something legal to play even if stopped before depth 1 completes
+    res.best = moves.moves[0];
+    res.score = sign * evaluate_stm(pos);
+
+    const int max_depth = (limits.depth > 0) ? std::min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+    const int multipv = std::clamp(limits.multipv, 1, moves.size);
+    uint64_t iter_nodes = 0, iter_qnodes = 0;
+    int64_t iter_ms = 0;
+
+    // Lines of the last completed iteration, best first; scores relative to
+    // the side to move
+    std::vector<int> prev_scores;
+    std::vector<std::vector<Move>> prev_pvs;
+
+    for (int d = 1; d <= max_depth; ++d) {
+        // One pass per line, each without the root moves found before it.
+        // The hash table and ordering state carry over between passes.
+        std::vector<std::pair<int, std::vector<Move>>> found;
+        root_excluded_.clear();
+        for (int k = 0; k < multipv; ++k) {
+            const int prev = k < (int)prev_scores.size() ? prev_scores[k] : 0;
+            int delta = params_.aspiration_window;
+            int alpha = -INF, beta = INF;
+            if (d > 1 && k < (int)prev_scores.size() && !is_mate_score(prev)) {
+                alpha = prev - delta;
+                beta  = prev + delta;
+            }
+            if (k < (int)prev_pvs.size()) prev_pv_ = prev_pvs[k];
+            else prev_pv_.clear();
+
+            int score;
+            while (true) {
+                follow_pv_ = true;
+                score = alphabeta(pos, d, 0, alpha, beta, false);
+                if (stopped_) break;
+
+                if (score <= alpha && alpha > -INF) {
+                    alpha = std::max(score - delta, -INF);
+                } else if (score >= beta && beta < INF) {
+                    beta = std::min(score + delta, INF);
+                } else {
+                    break;
+                }
+                delta *= 2;
+            }
+            if (stopped_ || pv_len_[0] == 0) break;
+
+            found.emplace_back(score, std::vector<Move>(pv_[0].begin(), pv_[0].begin() + pv_len_[0]));
+            root_excluded_.push_back(pv_[0][0]);
+        }
+        root_excluded_.clear();
+        if (stopped_ || found.empty()) break;
+
+        // A later pass can only come out ahead through search instability
+        std::stable_sort(found.begin(), found.end(),
+                         [](const auto& a, const auto& b) { return a.first > b.first; });
+        prev_scores.clear();
+        prev_pvs.clear();
+        res.lines.clear();
+        for (auto& [score, line] : found) {
+            prev_scores.push_back(score);
+            res.lines.push_back({sign * score, line});
+            prev_pvs.push_back(std::move(line));
+        }
+
+        res.best  = res.lines.front().pv.front();
+        res.score = res.lines.front().score;
+        res.depth = d;
+        res.pv    = res.lines.front().pv;
+
+        SEARCH_STAT({
+            IterationStats it;
+            it.depth = d;
+            it.seldepth = seldepth_;
+            it.nodes = nodes() - iter_nodes;
+            it.qnodes = stats_.qnodes - iter_qnodes;
+            it.time_ms = elapsed_ms() - iter_ms;
+            stats_.iterations.push_back(it);
+            iter_nodes = nodes();
+            iter_qnodes = stats_.qnodes;
+            iter_ms += it.time_ms;
+        });
+
+        if (on_info_) {
+            for (std::size_t k = 0; k < res.lines.size(); ++k) {
+                SearchInfo info;
+                info.depth = d;
+                info.seldepth = seldepth_;
+                info.score = res.lines[k].score;
+                info.nodes = nodes();
+                info.time_ms = elapsed_ms();
+                info.pv = res.lines[k].pv;
+                info.multipv = (int)k + 1;
+                (*on_info_)(info);
+            }
+        }
+
+        if (!pondering() && soft_ms_ && clock_ms() >= soft_ms_) break;
+        if (node_limit_ && nodes() >= node_limit_) break;
+    }
+
+    res.nodes = nodes();
+    SEARCH_STAT(stats_.nodes = res.nodes; stats_.seldepth = seldepth_; res.stats = stats_);
+    on_info_ = nullptr;
+    return res;
+}
+
+SearchResult Search::minimax(Position& pos, int depth) {
+    return minimax(pos, depth, SearchParams{});
+}
+
+SearchResult Search::minimax(Position& pos, int depth, const SearchParams& params) {
+    thread_local TranspositionTable tt(1);
+    tt.clear();
+    return minimax(pos, depth, params, tt);
+}
+
+SearchResult Search::minimax(Position& pos, int depth, const SearchParams& params,
+                             TranspositionTable& tt) {
+    tt.new_search();
+    Searcher searcher(tt, params);
+
+    SearchLimits limits;
+    limits.depth = std::max(1, depth);
+    return searcher.search(pos, limits);
+}
+
+}
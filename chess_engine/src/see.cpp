@@ -0,0 +1,97 @@
+#include "see.hpp"
+#include "rules.hpp"
+#include <algorithm>
+#include <array>
+
+namespace chess {
+
+int See::piece_value(Piece p) {
+    switch (p) {
+        case Piece::WP: case Piece::BP: return 100;
+        case Piece::WN: case Piece::BN: return 320;
+        case Piece::WB: case Piece::BB: return 330;
+        case Piece::WR: case Piece::BR: return 500;
+        case Piece::WQ: case Piece::BQ: return 900;
+        case Piece::WK: case Piece::BK: return 20000;
+        default: return 0;
+    }
+}
+
+static Piece promoted_piece(uint8_t promo, bool white) {
+    switch (promo) {
+        case PROMO_R: return white ? Piece::WR : Piece::BR;
+        case PROMO_B: return white ? Piece::WB : Piece::BB;
+        case PROMO_N: return white ? Piece::WN : Piece::BN;
+        default:      return white ? Piece::WQ : Piece::BQ;
+    }
+}
+
+// Swap-list algorithm; the list is folded back from the end with each side
+// choosing between standing pat and continuing the exchange. It plays on a
+// bare copy of the squares: nothing else about the position is needed, and
+// Position::set would update the hash key for every trade.
+int See::value(const Position& pos, const Move& m) {
+    const int to = m.to;
+    Piece mover = pos.at(m.from);
+    const bool white = is_white(mover);
+    const bool pawn = (mover == Piece::WP || mover == Piece::BP);
+    const bool last_rank = (rank_of(to) == 0 || rank_of(to) == 7);
+
+    std::array<Piece, 64> b = pos.board();
+    int gain[40];
+    int d = 0;
+
+    Piece captured = b[to];
+    if (pawn && is_empty(captured) && to == pos.ep_square() && file_of(to) != file_of(m.from)) {
+        int cap_sq = make_sq(file_of(to), rank_of(m.from));
+        captured = b[cap_sq];
+        b[cap_sq] = Piece::Empty;
+    }
+
+    gain[0] = piece_value(captured);
+    if (pawn && last_rank) {
+        mover = promoted_piece(m.promo, white);
+        gain[0] += piece_value(mover) - piece_value(white ? Piece::WP : Piece::BP);
+    }
+
+    b[to] = mover;
+    b[m.from] = Piece::Empty;
+
+    // gain[d]: what the side capturing at depth d has won if it does so
+    // and the sequence stops there. Computed before we know whether that
+    // side has an attacker at all, so the last entry is never folded in.
+    Color side = white ? Color::Black : Color::White;
+    Piece on_square = mover;
+    while (d < 38) {
+        ++d;
+        gain[d] = piece_value(on_square) - gain[d - 1];
+        // Can't change the outcome; unless a recapturing pawn might promote
+        if (!last_rank && std::max(-gain[d - 1], gain[d]) < 0) break;
+
+        int from = Rules::smallest_attacker(b, to, side);
+        if (from < 0) break;
+
+        // A king may only recapture when nothing defends the square
+        Piece attacker = b[from];
+        if ((attacker == Piece::WK || attacker == Piece::BK) &&
+            Rules::smallest_attacker(b, to, other(side)) >= 0) {
+            break;
+        }
+
+        // A pawn recapturing on the last rank promotes (to a queen)
+        if (last_rank && (attacker == Piece::WP || attacker == Piece::BP)) {
+            attacker = promoted_piece(PROMO_Q, attacker == Piece::WP);
+            gain[d] += piece_value(attacker) - piece_value(Piece::WP);
+        }
+
+        b[to] = attacker;
+        b[from] = Piece::Empty;
+        on_square = attacker;
+        side = other(side);
+    }
+
+    while (--d) gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    return gain[0];
+}
+
+} // namespace chess
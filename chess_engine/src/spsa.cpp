@@ -0,0 +1,205 @@
+#include "spsa.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace chess {
+
+Spsa::Spsa(const SpsaOptions& opts, std::vector<SpsaParam> params)
+    : opts_(opts), params_(std::move(params)) {}
+
+std::vector<SpsaParam> Spsa::default_params() {
+    const SearchParams d;
+    return {
+        {"aspiration_window",  (double)d.aspiration_window,  10, 150, 8,   0.002},
+        {"null_r_base",        (double)d.null_r_base,        1,  4,   0.5, 0.002},
+        {"lmr_min_move",       (double)d.lmr_min_move,       1,  8,   0.5, 0.002},
+        {"rfp_margin",         (double)d.rfp_margin,         30, 250, 10,  0.002},
+        {"futility_base",      (double)d.futility_base,      0,  300, 15,  0.002},
+        {"futility_per_depth", (double)d.futility_per_depth, 30, 300, 15,  0.002},
+        {"razor_margin",       (double)d.razor_margin,       100, 700, 30, 0.002},
+        {"lmp_base",           (double)d.lmp_base,           1,  10,  1,   0.002},
+    };
+}
+
+// c_k = c / (k + 1)^gamma with c chosen so that c_N = c_end;
+// a_k = a / (A + k + 1)^alpha with a_N = r_end * c_end^2.
+double Spsa::c_k(int i, int k) const {
+    const double n = std::max(1, opts_.iterations);
+    const double c = params_[i].c_end * std::pow(n, opts_.gamma);
+    return c / std::pow(k + 1.0, opts_.gamma);
+}
+
+double Spsa::a_k(int i, int k) const {
+    const double n = std::max(1, opts_.iterations);
+    const double big_a = opts_.a_ratio * n;
+    const double a_end = params_[i].r_end * params_[i].c_end * params_[i].c_end;
+    const double a = a_end * std::pow(big_a + n, opts_.alpha);
+    return a / std::pow(big_a + k + 1.0, opts_.alpha);
+}
+
+void Spsa::update(int k, const std::vector<int>& delta, double result) {
+    for (std::size_t i = 0; i < params_.size(); ++i) {
+        SpsaParam& p = params_[i];
+        p.value += a_k((int)i, k) / c_k((int)i, k) * result * delta[i];
+        p.value = std::clamp(p.value, p.min, p.max);
+    }
+}
+
+SearchParams Spsa::current() const {
+    SearchParams sp;
+    for (const SpsaParam& p : params_) sp.set(p.name, (int)std::lround(p.value));
+    return sp;
+}
+
+SearchParams Spsa::with_offsets(const std::vector<double>& theta, const std::vector<int>& delta,
+                                int k, int sign) const {
+    SearchParams sp;
+    for (std::size_t i = 0; i < params_.size(); ++i) {
+        const SpsaParam& p = params_[i];
+        double v = std::clamp(theta[i] + sign * c_k((int)i, k) * delta[i], p.min, p.max);
+        sp.set(p.name, (int)std::lround(v));
+    }
+    return sp;
+}
+
+void Spsa::worker(const std::vector<Opening>& openings, uint64_t seed, const Progress& progress,
+                  std::string& err) {
+    std::mt19937_64 rng(seed);
+    std::vector<double> theta(params_.size());
+    std::vector<int> delta(params_.size());
+
+    for (;;) {
+        int k;
+        {
+            std::lock_guard<std::mutex> lock(mu_);
+            if (stop_.load(std::memory_order_relaxed) || next_ >= opts_.iterations) return;
+            k = next_++;
+            for (std::size_t i = 0; i < params_.size(); ++i) theta[i] = params_[i].value;
+        }
+        for (int& d : delta) d = (rng() & 1) ? 1 : -1;
+
+        EngineConfig plus, minus;
+        plus.name = "plus";
+        minus.name = "minus";
+        plus.hash_mb = minus.hash_mb = opts_.match.a.hash_mb;
+        plus.params = with_offsets(theta, delta, k, +1);
+        minus.params = with_offsets(theta, delta, k, -1);
+
+        const Opening& op = openings[rng() % openings.size()];
+        GameRecord g1 = Match::play_game(plus, minus, op, opts_.match, &stop_);
+        GameRecord g2 = Match::play_game(minus, plus, op, opts_.match, &stop_);
+        if (g1.aborted || g2.aborted) return;
+        const double result = g1.result - g2.result;
+
+        std::lock_guard<std::mutex> lock(mu_);
+        update(k, delta, result);
+        ++iteration_;
+        if (!opts_.checkpoint.empty() && iteration_ % std::max(1, opts_.checkpoint_every) == 0) {
+            if (!save(opts_.checkpoint, err)) stop();
+        }
+        if (progress) progress(iteration_, params_);
+    }
+}
+
+bool Spsa::run(std::string& err, const Progress& progress) {
+    if (!opts_.checkpoint.empty() && std::ifstream(opts_.checkpoint) && !load(opts_.checkpoint, err))
+        return false;
+
+    std::vector<Opening> openings;
+    if (opts_.match.openings.empty()) openings.emplace_back();
+    else if (!Match::load_openings(opts_.match.openings, openings, err)) return false;
+    if (openings.empty()) {
+        err = "No openings";
+        return false;
+    }
+
+    stop_ = false;
+    next_ = iteration_;
+    const int nthreads = opts_.match.concurrency > 0 ? opts_.match.concurrency
+                                                     : std::max(1, (int)std::thread::hardware_concurrency());
+    const uint64_t seed = opts_.seed ? opts_.seed : std::random_device{}();
+
+    std::vector<std::string> errors(nthreads);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < nthreads; ++t) {
+        const uint64_t s = seed + 0x9E3779B97F4A7C15ULL * (uint64_t)(t + 1) + (uint64_t)iteration_;
+        pool.emplace_back([&, t, s]() { worker(openings, s, progress, errors[t]); });
+    }
+    for (auto& th : pool) th.join();
+
+    for (const std::string& e : errors) {
+        if (!e.empty()) {
+            err = e;
+            return false;
+        }
+    }
+    return opts_.checkpoint.empty() || save(opts_.checkpoint, err);
+}
+
+// Text checkpoint:
+//   iteration <n>
+//   <name> <value> <min> <max> <c_end> <r_end>     one line per parameter
+// Written to a temporary file and renamed over the old one.
+bool Spsa::save(const std::string& path, std::string& err) const {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out) {
+            err = "Cannot write " + tmp;
+            return false;
+        }
+        out.precision(17);
+        out << "iteration " << iteration_ << "\n";
+        for (const SpsaParam& p : params_)
+            out << p.name << " " << p.value << " " << p.min << " " << p.max << " " << p.c_end << " "
+                << p.r_end << "\n";
+        if (!out) {
+            err = "Write failed: " + tmp;
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        err = "Cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+bool Spsa::load(const std::string& path, std::string& err) {
+    std::ifstream in(path);
+    if (!in) {
+        err = "Cannot read " + path;
+        return false;
+    }
+
+    std::string word;
+    int iteration = 0;
+    if (!(in >> word >> iteration) || word != "iteration" || iteration < 0) {
+        err = "Not an SPSA checkpoint: " + path;
+        return false;
+    }
+
+    std::vector<SpsaParam> params;
+    SearchParams probe;
+    for (SpsaParam p; in >> p.name >> p.value >> p.min >> p.max >> p.c_end >> p.r_end;) {
+        if (!probe.set(p.name, 0)) {
+            err = "Unknown search parameter in checkpoint: " + p.name;
+            return false;
+        }
+        params.push_back(p);
+    }
+    if (params.empty()) {
+        err = "No parameters in checkpoint: " + path;
+        return false;
+    }
+
+    params_ = std::move(params);
+    iteration_ = iteration;
+    return true;
+}
+
+} // namespace chess
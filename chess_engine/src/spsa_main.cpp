@@ -0,0 +1,96 @@
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "spsa.hpp"
+
+// SPSA tuning of search parameters through self-play:
+//   ichigo_spsa [options]
+// Progress is checkpointed; rerunning with the same --checkpoint resumes.
+
+static void usage() {
+    std::cerr << "usage: ichigo_spsa [options]\n"
+                 "  --iterations N     game pairs (default 1000)\n"
+                 "  --tc S+INC         clock per game in seconds, e.g. 5+0.05\n"
+                 "  --nodes N          node budget per move\n"
+                 "  --depth N          depth per move (default 6 if no other limit)\n"
+                 "  --concurrency N    game pairs at once (default: all cores)\n"
+                 "  --openings FILE    EPD/FEN lines or PGN\n"
+                 "  --hash MB          hash per engine (default 16)\n"
+                 "  --max-plies N      adjudicate longer games as draws (default 400)\n"
+                 "  --params LIST      tune only these, e.g. \"rfp_margin,razor_margin\"\n"
+                 "  --checkpoint FILE  resume from and save to FILE (default spsa.txt)\n"
+                 "  --every N          iterations between checkpoints (default 16)\n"
+                 "  --seed N\n";
+}
+
+static void parse_tc(const std::string& s, chess::TimeControl& tc) {
+    std::size_t plus = s.find('+');
+    tc.base_ms = (int64_t)(std::stod(s.substr(0, plus)) * 1000);
+    if (plus != std::string::npos) tc.inc_ms = (int64_t)(std::stod(s.substr(plus + 1)) * 1000);
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    SpsaOptions opts;
+    opts.checkpoint = "spsa.txt";
+    std::string only;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--iterations" && i + 1 < argc)       opts.iterations = std::stoi(argv[++i]);
+            else if (a == "--tc" && i + 1 < argc)          parse_tc(argv[++i], opts.match.tc);
+            else if (a == "--nodes" && i + 1 < argc)       opts.match.tc.nodes = std::stoull(argv[++i]);
+            else if (a == "--depth" && i + 1 < argc)       opts.match.tc.depth = std::stoi(argv[++i]);
+            else if (a == "--concurrency" && i + 1 < argc) opts.match.concurrency = std::stoi(argv[++i]);
+            else if (a == "--openings" && i + 1 < argc)    opts.match.openings = argv[++i];
+            else if (a == "--hash" && i + 1 < argc)        opts.match.a.hash_mb = (std::size_t)std::max(1, std::stoi(argv[++i]));
+            else if (a == "--max-plies" && i + 1 < argc)   opts.match.max_plies = std::stoi(argv[++i]);
+            else if (a == "--params" && i + 1 < argc)      only = argv[++i];
+            else if (a == "--checkpoint" && i + 1 < argc)  opts.checkpoint = argv[++i];
+            else if (a == "--every" && i + 1 < argc)       opts.checkpoint_every = std::stoi(argv[++i]);
+            else if (a == "--seed" && i + 1 < argc)        opts.seed = std::stoull(argv[++i]);
+            else if (a == "-h" || a == "--help")           { usage(); return 0; }
+            else                                           { usage(); return 1; }
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    const TimeControl& tc = opts.match.tc;
+    if (tc.base_ms == 0 && tc.movetime_ms == 0 && tc.nodes == 0 && tc.depth == 0) opts.match.tc.depth = 6;
+
+    std::vector<SpsaParam> params;
+    for (const SpsaParam& p : Spsa::default_params()) {
+        if (only.empty() || ("," + only + ",").find("," + p.name + ",") != std::string::npos)
+            params.push_back(p);
+    }
+    if (params.empty()) {
+        std::cerr << "No tunable parameters selected\n";
+        return 1;
+    }
+
+    Spsa spsa(opts, params);
+    std::string err;
+    bool ok = spsa.run(err, [](int iteration, const std::vector<SpsaParam>& ps) {
+        std::printf("iteration %d:", iteration);
+        for (const SpsaParam& p : ps) std::printf(" %s=%.2f", p.name.c_str(), p.value);
+        std::printf("\n");
+        std::fflush(stdout);
+    });
+    if (!ok) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    std::printf("Tuned (%d iterations):\n", spsa.iteration());
+    const SearchParams sp = spsa.current();
+    for (const SpsaParam& p : spsa.params()) {
+        for (const auto& [name, field] : SearchParams::fields())
+            if (p.name == name) std::printf("  %s = %d\n", name, sp.*field);
+    }
+    return 0;
+}
@@ -0,0 +1,615 @@
+#include "tablebase.hpp"
+#include "movegen.hpp"
+#include "rules.hpp"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace chess {
+
+namespace {
+
+// Piece letters in table names, strongest first
+constexpr const char* LETTERS = "QRBNP";
+
+constexpr std::size_t NONE = ~std::size_t(0);
+constexpr int MAX_DTM = 127;
+
+// File header: "ICTB", version, piece count, 2 reserved, entries (LE u64)
+constexpr char MAGIC[4] = {'I', 'C', 'T', 'B'};
+constexpr uint8_t VERSION = 1;
+constexpr std::size_t HEADER_SIZE = 16;
+
+// Byte per position: 0 draw, 1..127 win in n plies, 128 + n loss in n plies.
+uint8_t encode_value(Wdl wdl, int dtm) {
+    if (wdl == Wdl::Win) return (uint8_t)dtm;
+    if (wdl == Wdl::Loss) return (uint8_t)(128 + dtm);
+    return 0;
+}
+
+TbResult decode_value(uint8_t v) {
+    if (v == 0) return {Wdl::Draw, 0};
+    if (v < 128) return {Wdl::Win, v};
+    return {Wdl::Loss, v - 128};
+}
+
+Piece from_letter(char c, bool white) {
+    switch (c) {
+        case 'Q': return white ? Piece::WQ : Piece::BQ;
+        case 'R': return white ? Piece::WR : Piece::BR;
+        case 'B': return white ? Piece::WB : Piece::BB;
+        case 'N': return white ? Piece::WN : Piece::BN;
+        case 'P': return white ? Piece::WP : Piece::BP;
+        default:  return Piece::Empty;
+    }
+}
+
+char letter(Piece p) {
+    return "PNBRQK"[(static_cast<int>(p) - 1) % 6];
+}
+
+bool is_pawn(Piece p) { return p == Piece::WP || p == Piece::BP; }
+
+int letter_value(char c) {
+    switch (c) {
+        case 'Q': return 9;
+        case 'R': return 5;
+        case 'B': case 'N': return 3;
+        case 'P': return 1;
+        default: return 0;
+    }
+}
+
+// Non-king pieces of one side, strongest first ("QRP")
+std::string sort_side(std::string s) {
+    std::sort(s.begin(), s.end(), [](char a, char b) {
+        return std::strchr(LETTERS, a) < std::strchr(LETTERS, b);
+    });
+    return s;
+}
+
+// True if side a should be named first (more material, then stronger pieces)
+bool stronger(const std::string& a, const std::string& b) {
+    int va = 0, vb = 0;
+    for (char c : a) va += letter_value(c);
+    for (char c : b) vb += letter_value(c);
+    if (va != vb) return va > vb;
+    if (a.size() != b.size()) return a.size() > b.size();
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i]) return std::strchr(LETTERS, a[i]) < std::strchr(LETTERS, b[i]);
+    }
+    return false;
+}
+
+std::string make_name(std::string white, std::string black, bool* flipped = nullptr) {
+    white = sort_side(white);
+    black = sort_side(black);
+    bool flip = stronger(black, white);
+    if (flipped) *flipped = flip;
+    return flip ? "K" + black + "vK" + white : "K" + white + "vK" + black;
+}
+
+// No mate is possible at all: no table needed
+bool trivially_drawn(const std::string& name) {
+    return name == "KvK" || name == "KBvK" || name == "KNvK";
+}
+
+// The white king is folded into a1-d1-d4 by the board's symmetries (only
+// the a-d files when pawns fix the orientation).
+using Layout = TbLayout;
+
+struct KingSlots {
+    int8_t triangle[64];
+    int8_t half[64];
+    int triangle_sq[10];
+    int half_sq[32];
+
+    KingSlots() {
+        int t = 0, h = 0;
+        for (int sq = 0; sq < 64; ++sq) {
+            int f = file_of(sq), r = rank_of(sq);
+            triangle[sq] = -1;
+            half[sq] = -1;
+            if (r <= f && f <= 3) { triangle[sq] = (int8_t)t; triangle_sq[t++] = sq; }
+            if (f <= 3)           { half[sq] = (int8_t)h; half_sq[h++] = sq; }
+        }
+    }
+};
+
+const KingSlots KING_SLOTS;
+
+bool parse_layout(const std::string& name, Layout& out) {
+    std::size_t v = name.find('v');
+    if (name.size() < 3 || name[0] != 'K' || v == std::string::npos ||
+        v + 1 >= name.size() || name[v + 1] != 'K')
+        return false;
+
+    std::string white = name.substr(1, v - 1), black = name.substr(v + 2);
+    for (char c : white + black)
+        if (!std::strchr(LETTERS, c)) return false;
+    if (make_name(white, black) != name) return false;
+    if (2 + white.size() + black.size() > (std::size_t)Tablebase::MAX_PIECES) return false;
+
+    out = Layout{};
+    out.pieces = {Piece::WK, Piece::BK};
+    for (char c : white) out.pieces.push_back(from_letter(c, true));
+    for (char c : black) out.pieces.push_back(from_letter(c, false));
+    for (Piece p : out.pieces) out.pawns |= is_pawn(p);
+
+    out.size = out.pawns ? 32 : 10;
+    for (std::size_t i = 1; i < out.pieces.size(); ++i) out.size *= 64;
+    out.size *= 2;
+    return true;
+}
+
+int transform(int sq, int t) {
+    int f = file_of(sq), r = rank_of(sq);
+    if (t & 1) f = 7 - f;
+    if (t & 2) r = 7 - r;
+    if (t & 4) std::swap(f, r);
+    return make_sq(f, r);
+}
+
+// Smallest index over the symmetric images, so every position has exactly
+// one index; NONE if the squares don't fit the layout.
+std::size_t encode(const Layout& L, const int* sq, int stm) {
+    const int n = (int)L.pieces.size();
+    const int transforms = L.pawns ? 2 : 8;
+    std::size_t best = NONE;
+
+    for (int t = 0; t < transforms; ++t) {
+        int s[Tablebase::MAX_PIECES];
+        for (int i = 0; i < n; ++i) s[i] = transform(sq[i], t);
+
+        int slot = L.pawns ? KING_SLOTS.half[s[0]] : KING_SLOTS.triangle[s[0]];
+        if (slot < 0) continue;
+
+        // Identical pieces are interchangeable: keep them in square order
+        for (int i = 2; i + 1 < n; ++i)
+            if (L.pieces[i] == L.pieces[i + 1] && s[i] > s[i + 1]) std::swap(s[i], s[i + 1]);
+
+        std::size_t idx = (std::size_t)slot;
+        for (int i = 1; i < n; ++i) idx = idx * 64 + (std::size_t)s[i];
+        idx = idx * 2 + (std::size_t)stm;
+        best = std::min(best, idx);
+    }
+    return best;
+}
+
+void decode(const Layout& L, std::size_t idx, int* sq, int& stm) {
+    const int n = (int)L.pieces.size();
+    stm = (int)(idx & 1);
+    idx >>= 1;
+    for (int i = n - 1; i >= 1; --i) {
+        sq[i] = (int)(idx & 63);
+        idx >>= 6;
+    }
+    sq[0] = L.pawns ? KING_SLOTS.half_sq[idx] : KING_SLOTS.triangle_sq[idx];
+}
+
+// Squares of pos's pieces in layout order, optionally with colours swapped
+// and the board mirrored. false if the material doesn't match.
+bool squares_of(const Layout& L, const Position& pos, bool flip, int* sq) {
+    const int n = (int)L.pieces.size();
+    bool used[Tablebase::MAX_PIECES] = {};
+    int found = 0;
+
+    for (int s = 0; s < 64; ++s) {
+        Piece p = pos.at(s);
+        if (is_empty(p)) continue;
+        int ms = s;
+        if (flip) {
+            int code = static_cast<int>(p);
+            p = static_cast<Piece>(code <= 6 ? code + 6 : code - 6);
+            ms = s ^ 56;
+        }
+        int slot = -1;
+        for (int i = 0; i < n && slot < 0; ++i)
+            if (!used[i] && L.pieces[i] == p) slot = i;
+        if (slot < 0) return false;
+        used[slot] = true;
+        sq[slot] = ms;
+        ++found;
+    }
+    return found == n;
+}
+
+Position build(const Layout& L, const int* sq, int stm) {
+    Position pos;
+    for (std::size_t i = 0; i < L.pieces.size(); ++i) pos.set(sq[i], L.pieces[i]);
+    pos.set_side_to_move(stm == 0 ? Color::White : Color::Black);
+    return pos;
+}
+
+// A legal position with this index as its canonical one
+bool valid(const Layout& L, std::size_t idx, const int* sq, int stm) {
+    const int n = (int)L.pieces.size();
+    for (int i = 0; i < n; ++i) {
+        if (is_pawn(L.pieces[i]) && (rank_of(sq[i]) == 0 || rank_of(sq[i]) == 7)) return false;
+        for (int j = 0; j < i; ++j)
+            if (sq[i] == sq[j]) return false;
+    }
+    if (encode(L, sq, stm) != idx) return false;
+
+    // The side that just moved may not be in check (covers touching kings)
+    Position pos = build(L, sq, stm);
+    return !Rules::in_check(pos, other(pos.side_to_move()));
+}
+
+std::size_t index_of(const Layout& L, const Position& pos) {
+    int sq[Tablebase::MAX_PIECES];
+    if (!squares_of(L, pos, false, sq)) return NONE;
+    return encode(L, sq, pos.side_to_move() == Color::White ? 0 : 1);
+}
+
+// Positions one move earlier, without captures or promotions (those start
+// in a different table). Candidate squares come from the pseudo-legal moves
+// of the side that just moved, since pieces other than pawns move both ways
+// alike; pawns step backwards by hand.
+void predecessors(const Layout& L, const Position& q, std::vector<std::size_t>& out) {
+    out.clear();
+    const Color s = q.side_to_move();
+    const Color m = other(s);
+
+    Position r = q;
+    r.set_side_to_move(m);
+    r.set_ep_square(-1);
+
+    auto add = [&](int from_now, int from_before) {
+        Position p = r;
+        Piece pc = p.at(from_now);
+        p.set(from_before, pc);
+        p.set(from_now, Piece::Empty);
+        if (Rules::in_check(p, s)) return;
+        std::size_t idx = index_of(L, p);
+        if (idx != NONE && std::find(out.begin(), out.end(), idx) == out.end()) out.push_back(idx);
+    };
+
+    MoveList pl;
+    MoveGen::generate_pseudo_legal(r, pl);
+    for (int i = 0; i < pl.size; ++i) {
+        const Move& mv = pl.moves[i];
+        if (is_pawn(r.at(mv.from)) || !is_empty(r.at(mv.to))) continue;
+        add(mv.from, mv.to);
+    }
+
+    const bool white = (m == Color::White);
+    const Piece pawn = white ? Piece::WP : Piece::BP;
+    const int back = white ? -8 : 8;
+    for (int sq = 0; sq < 64; ++sq) {
+        if (r.at(sq) != pawn) continue;
+        int one = sq + back;
+        int start_rank = white ? 1 : 6;
+        if (rank_of(one) == (white ? 0 : 7) || !is_empty(r.at(one))) continue;
+        add(sq, one);
+        if (rank_of(sq) == start_rank + (white ? 2 : -2)) {
+            int two = one + back;
+            if (is_empty(r.at(two))) add(sq, two);
+        }
+    }
+}
+
+enum Kind : uint8_t { KIND_WIN, KIND_LOSS };
+
+struct Candidate {
+    std::size_t idx;
+    Kind kind;
+};
+
+enum State : uint8_t { UNKNOWN, RESOLVED, INVALID };
+
+// Retrograde analysis with move counting. The first pass scores terminal
+// positions and moves that leave the table (captures, promotions) from
+// the smaller tables; distances are then resolved level by level: a loss
+// in n makes every predecessor a win in n + 1, and a position whose moves
+// inside the table all turn out won for the opponent is lost.
+bool retrograde(const Layout& L, const Tablebase& tb, int threads,
+                std::vector<uint8_t>& out, std::string& err) {
+    const std::size_t N = L.size;
+    std::vector<uint8_t> state(N, UNKNOWN), cnt(N, 0), exit_loss(N, 0), nonloss(N, 0);
+    out.assign(N, 0);
+
+    std::vector<std::vector<Candidate>> buckets(MAX_DTM + 2);
+    std::mutex mu;
+    std::atomic<bool> failed{false};
+    std::atomic<std::size_t> next{0};
+    constexpr std::size_t BLOCK = 4096;
+
+    auto init_worker = [&]() {
+        std::vector<std::vector<Candidate>> local(MAX_DTM + 2);
+        std::vector<std::size_t> children;
+        std::string merr;
+
+        for (std::size_t begin; (begin = next.fetch_add(BLOCK)) < N && !failed;) {
+            for (std::size_t idx = begin; idx < std::min(N, begin + BLOCK); ++idx) {
+                int sq[Tablebase::MAX_PIECES], stm;
+                decode(L, idx, sq, stm);
+                if (!valid(L, idx, sq, stm)) { state[idx] = INVALID; continue; }
+
+                Position pos = build(L, sq, stm);
+                MoveList legal;
+                MoveGen::generate_legal(pos, legal);
+                if (legal.size == 0) {
+                    if (Rules::in_check(pos, pos.side_to_move())) local[0].push_back({idx, KIND_LOSS});
+                    else state[idx] = RESOLVED;   // stalemate
+                    continue;
+                }
+
+                int win = INT_MAX, loss = 0;
+                bool draw_or_better = false;
+                children.clear();
+
+                for (int i = 0; i < legal.size; ++i) {
+                    const Move& m = legal.moves[i];
+                    const bool leaves = !is_empty(pos.at(m.to)) || m.promo != PROMO_NONE;
+                    Position child = pos;
+                    child.make_move(m, merr);
+
+                    if (!leaves) {
+                        std::size_t c = index_of(L, child);
+                        if (std::find(children.begin(), children.end(), c) == children.end())
+                            children.push_back(c);
+                        continue;
+                    }
+
+                    auto r = tb.probe(child);
+                    if (!r) {
+                        std::lock_guard<std::mutex> lock(mu);
+                        if (!failed) err = "Missing table " + Tablebase::material_name(child);
+                        failed = true;
+                        break;
+                    }
+                    if (r->wdl == Wdl::Loss) { win = std::min(win, r->dtm + 1); draw_or_better = true; }
+                    else if (r->wdl == Wdl::Draw) draw_or_better = true;
+                    else loss = std::max(loss, r->dtm + 1);
+                }
+
+                cnt[idx] = (uint8_t)children.size();
+                nonloss[idx] = draw_or_better;
+                exit_loss[idx] = (uint8_t)std::min(loss, MAX_DTM + 1);
+
+                if (win != INT_MAX) local[std::min(win, MAX_DTM + 1)].push_back({idx, KIND_WIN});
+                else if (children.empty() && draw_or_better) state[idx] = RESOLVED;
+                else if (children.empty()) local[std::min(loss, MAX_DTM + 1)].push_back({idx, KIND_LOSS});
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mu);
+        for (int d = 0; d <= MAX_DTM + 1; ++d)
+            buckets[d].insert(buckets[d].end(), local[d].begin(), local[d].end());
+    };
+
+    if (threads <= 0) threads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(init_worker);
+    init_worker();
+    for (auto& t : pool) t.join();
+    if (failed) return false;
+
+    std::vector<std::size_t> preds;
+    for (int d = 0; d <= MAX_DTM + 1; ++d) {
+        for (std::size_t k = 0; k < buckets[d].size(); ++k) {
+            const Candidate c = buckets[d][k];
+            if (state[c.idx] != UNKNOWN) continue;
+            if (d > MAX_DTM) {
+                err = "Distance to mate exceeds " + std::to_string(MAX_DTM) + " plies";
+                return false;
+            }
+
+            state[c.idx] = RESOLVED;
+            out[c.idx] = encode_value(c.kind == KIND_WIN ? Wdl::Win : Wdl::Loss, d);
+
+            int sq[Tablebase::MAX_PIECES], stm;
+            decode(L, c.idx, sq, stm);
+            predecessors(L, build(L, sq, stm), preds);
+
+            for (std::size_t q : preds) {
+                if (state[q] != UNKNOWN) continue;
+                if (c.kind == KIND_LOSS) {
+                    buckets[d + 1].push_back({q, KIND_WIN});
+                } else if (--cnt[q] == 0 && !nonloss[q]) {
+                    int when = std::min(std::max<int>(d + 1, exit_loss[q]), MAX_DTM + 1);
+                    buckets[when].push_back({q, KIND_LOSS});
+                }
+            }
+        }
+        std::vector<Candidate>().swap(buckets[d]);
+    }
+
+    // Whatever is left can always avoid losing: a draw (stored as 0)
+    return true;
+}
+
+} // namespace
+
+std::string Tablebase::material_name(const Position& pos) {
+    std::string white, black;
+    bool wk = false, bk = false;
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p)) continue;
+        if (p == Piece::WK) wk = true;
+        else if (p == Piece::BK) bk = true;
+        else (is_white(p) ? white : black) += letter(p);
+    }
+    if (!wk || !bk) return "";
+    return make_name(white, black);
+}
+
+std::vector<std::string> Tablebase::all_names(int n) {
+    std::set<std::pair<std::size_t, std::string>> names;
+
+    // Every split of up to n - 2 pieces between the sides
+    std::vector<std::string> sides = {""};
+    for (int k = 1; k <= n - 2; ++k) {
+        std::vector<std::string> grown;
+        for (const auto& s : sides)
+            if ((int)s.size() == k - 1)
+                for (const char* c = LETTERS; *c; ++c) grown.push_back(sort_side(s + *c));
+        sides.insert(sides.end(), grown.begin(), grown.end());
+    }
+    for (const auto& w : sides)
+        for (const auto& b : sides)
+            if ((int)(w.size() + b.size()) <= n - 2) {
+                std::string name = make_name(w, b);
+                if (!trivially_drawn(name)) names.insert({w.size() + b.size(), name});
+            }
+
+    std::vector<std::string> out;
+    for (const auto& e : names) out.push_back(e.second);
+    return out;
+}
+
+void Tablebase::clear() {
+    tables_.clear();
+    max_pieces_ = 0;
+}
+
+bool Tablebase::has(const std::string& name) const {
+    return trivially_drawn(name) || tables_.count(name) > 0;
+}
+
+std::optional<TbResult> Tablebase::probe(const Position& pos) const {
+    if (pos.castling_rights() != CR_NONE || pos.ep_square() != -1) return std::nullopt;
+
+    std::string white, black;
+    int n = 0;
+    for (int sq = 0; sq < 64; ++sq) {
+        Piece p = pos.at(sq);
+        if (is_empty(p)) continue;
+        if (++n > MAX_PIECES) return std::nullopt;
+        if (p != Piece::WK && p != Piece::BK) (is_white(p) ? white : black) += letter(p);
+    }
+
+    bool flip = false;
+    std::string name = make_name(white, black, &flip);
+    if (trivially_drawn(name)) return TbResult{};
+
+    auto it = tables_.find(name);
+    if (it == tables_.end()) return std::nullopt;
+
+    const Layout& L = it->second.layout;
+    int sq[MAX_PIECES];
+    if (!squares_of(L, pos, flip, sq)) return std::nullopt;
+
+    int stm = (pos.side_to_move() == Color::White) ? 0 : 1;
+    if (flip) stm ^= 1;
+    std::size_t idx = encode(L, sq, stm);
+    if (idx == NONE || idx >= it->second.size) return std::nullopt;
+    return decode_value(it->second.data[idx]);
+}
+
+bool Tablebase::generate(const std::string& name, std::string& err, int threads) {
+    if (has(name)) return true;
+
+    Layout L;
+    if (!parse_layout(name, L)) {
+        err = "Not a table name: " + name;
+        return false;
+    }
+
+    // Tables reached by a capture or a promotion come first
+    std::string white, black;
+    for (std::size_t i = 2; i < L.pieces.size(); ++i)
+        (is_white(L.pieces[i]) ? white : black) += letter(L.pieces[i]);
+    for (int side = 0; side < 2; ++side) {
+        const std::string& mine = side == 0 ? white : black;
+        const std::string& theirs = side == 0 ? black : white;
+        for (std::size_t i = 0; i < mine.size(); ++i) {
+            std::string rest = mine.substr(0, i) + mine.substr(i + 1);
+            std::vector<std::string> deps = {side == 0 ? make_name(rest, theirs) : make_name(theirs, rest)};
+            if (mine[i] == 'P') {
+                for (char promo : std::string("QRBN")) {
+                    std::string up = rest + promo;
+                    deps.push_back(side == 0 ? make_name(up, theirs) : make_name(theirs, up));
+                }
+            }
+            for (const auto& d : deps)
+                if (!generate(d, err, threads)) return false;
+        }
+    }
+
+    Table t;
+    t.layout = L;
+    if (!retrograde(L, *this, threads, t.memory, err)) return false;
+    t.data = t.memory.data();
+    t.size = t.memory.size();
+    tables_[name] = std::move(t);
+    max_pieces_ = std::max(max_pieces_, (int)L.pieces.size());
+    return true;
+}
+
+bool Tablebase::save(const std::string& name, const std::string& dir, std::string& err) const {
+    auto it = tables_.find(name);
+    if (it == tables_.end()) {
+        err = "No table " + name;
+        return false;
+    }
+
+    std::string path = (std::filesystem::path(dir) / (name + ".itb")).string();
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        err = "Cannot write " + path;
+        return false;
+    }
+
+    unsigned char header[HEADER_SIZE] = {};
+    std::memcpy(header, MAGIC, 4);
+    header[4] = VERSION;
+    header[5] = (unsigned char)(name.size() - 1);   // pieces = letters minus 'v'
+    uint64_t n = it->second.size;
+    for (int i = 0; i < 8; ++i) header[8 + i] = (unsigned char)(n >> (8 * i));
+
+    out.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+    out.write(reinterpret_cast<const char*>(it->second.data), (std::streamsize)n);
+    if (!out) {
+        err = "Write failed: " + path;
+        return false;
+    }
+    return true;
+}
+
+bool Tablebase::load_dir(const std::string& dir, std::string& err) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) {
+        err = "Not a directory: " + dir;
+        return false;
+    }
+
+    for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.path().extension() != ".itb") continue;
+        std::string name = entry.path().stem().string();
+
+        Layout L;
+        if (!parse_layout(name, L)) continue;
+
+        Table t;
+        t.layout = L;
+        if (!t.file.open(entry.path().string(), err)) return false;
+
+        const unsigned char* h = t.file.data();
+        uint64_t n = 0;
+        if (t.file.size() >= HEADER_SIZE)
+            for (int i = 0; i < 8; ++i) n |= (uint64_t)h[8 + i] << (8 * i);
+
+        if (t.file.size() < HEADER_SIZE || std::memcmp(h, MAGIC, 4) != 0 || h[4] != VERSION ||
+            n != L.size || t.file.size() != HEADER_SIZE + n) {
+            err = "Corrupt or outdated table: " + entry.path().string();
+            return false;
+        }
+
+        t.data = h + HEADER_SIZE;
+        t.size = (std::size_t)n;
+        tables_[name] = std::move(t);
+        max_pieces_ = std::max(max_pieces_, (int)L.pieces.size());
+    }
+    return true;
+}
+
+} // namespace chess
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tablebase.hpp"
+
+// Generates endgame tables by retrograde analysis:
+//   ichigo_tb [--dir DIR] [--threads N] all3 | all4 | KQvK KRPvK ...
+// Tables already in DIR are reused as dependencies and not rebuilt.
+
+static void usage() {
+    std::cerr << "usage: ichigo_tb [--dir DIR] [--threads N] all3|all4|TABLE...\n"
+                 "  TABLE is the material, stronger side first: KQvK, KRPvK, KQvKR\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    std::string dir = ".";
+    int threads = 0;
+    std::vector<std::string> names;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--dir" && i + 1 < argc)          dir = argv[++i];
+            else if (a == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+            else if (a == "all3" || a == "all4") {
+                for (const auto& n : Tablebase::all_names(a == "all3" ? 3 : 4)) names.push_back(n);
+            }
+            else if (a == "-h" || a == "--help")       { usage(); return 0; }
+            else if (a.rfind("--", 0) == 0)            { usage(); return 1; }
+            else names.push_back(a);
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    if (names.empty()) {
+        usage();
+        return 1;
+    }
+
+    Tablebase tb;
+    std::string err;
+    if (!tb.load_dir(dir, err)) {
+        std::cerr << err << "\n";
+        return 1;
+    }
+
+    for (const auto& name : names) {
+        if (tb.has(name)) continue;
+
+        auto t0 = std::chrono::steady_clock::now();
+        if (!tb.generate(name, err, threads)) {
+            std::cerr << name << ": " << err << "\n";
+            return 1;
+        }
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        // generate() may have built dependencies too: save whatever is new
+        for (const auto& n : Tablebase::all_names(Tablebase::MAX_PIECES)) {
+            if (!tb.has(n)) continue;
+            std::string path = dir + "/" + n + ".itb";
+            std::error_code ec;
+            if (std::filesystem::exists(path, ec)) continue;
+            if (!tb.save(n, dir, err)) {
+                std::cerr << err << "\n";
+                return 1;
+            }
+            std::cout << "Wrote " << path << "\n";
+        }
+        std::cout << name << " done in " << secs << " s\n";
+    }
+    return 0;
+}
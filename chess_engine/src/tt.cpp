@@ -0,0 +1,235 @@
+#include "tt.hpp"
+#include "mapped_file.hpp"
+#include "zobrist.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace chess {
+
+// data layout: score:32 | depth:8 | bound:2 | gen:6 | move:16
+static uint64_t pack(const Move& m, int score, int depth, Bound bound, uint8_t gen) {
+    uint64_t mv = (uint64_t)m.from | ((uint64_t)m.to << 6) | ((uint64_t)m.promo << 12);
+    return ((uint64_t)(uint32_t)score << 32) |
+           ((uint64_t)(uint8_t)depth << 24) |
+           ((uint64_t)bound << 22) |
+           ((uint64_t)(gen & 63) << 16) |
+           mv;
+}
+
+static uint8_t gen_of(uint64_t data) { return (uint8_t)((data >> 16) & 63); }
+static int depth_of(uint64_t data)   { return (int)(uint8_t)(data >> 24); }
+
+// Snapshot header:
+//   [0, 4)   "ICTT"          [4]  version      [5]  slot size   [6] generation
+//   [8, 16)  slot count      [16, 24) Zobrist fingerprint   [24, 32) checksum
+// All integers little-endian; each slot is check then data.
+static constexpr char SNAPSHOT_MAGIC[4] = {'I', 'C', 'T', 'T'};
+static constexpr uint8_t SNAPSHOT_VERSION = 1;
+static constexpr std::size_t SNAPSHOT_HEADER = 32;
+static constexpr std::size_t SNAPSHOT_SLOT = 16;
+
+static void put_le(unsigned char* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t get_le(const unsigned char* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+// Keys from a build with different Zobrist tables would never match, so
+// such a snapshot is rejected instead of silently loading as misses.
+static uint64_t zobrist_fingerprint() {
+    uint64_t h = 0;
+    auto mix = [&h](uint64_t k) { h = (h ^ k) * 0x100000001B3ULL; h ^= h >> 29; };
+    for (int p = 1; p < 13; ++p)
+        for (int sq = 0; sq < 64; ++sq) mix(Zobrist::piece(static_cast<Piece>(p), sq));
+    for (int cr = 0; cr < 16; ++cr) mix(Zobrist::castling((uint8_t)cr));
+    for (int f = 0; f < 8; ++f) mix(Zobrist::ep_file(f));
+    mix(Zobrist::side());
+    return h;
+}
+
+static void checksum_add(uint64_t& h, uint64_t word) {
+    h = (h ^ word) * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 32;
+}
+
+TranspositionTable::TranspositionTable(std::size_t mb) {
+    resize(mb);
+}
+
+void TranspositionTable::resize(std::size_t mb) {
+    mb = std::max<std::size_t>(1, mb);
+
+    // Round down to a power of two so the index is a mask
+    std::size_t want = mb * 1024 * 1024 / sizeof(Slot);
+    std::size_t n = 1;
+    while (n * 2 <= want) n *= 2;
+
+    slots_ = std::make_unique<Slot[]>(n);
+    count_ = n;
+    mb_ = mb;
+    gen_ = 0;
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < count_; ++i) {
+        slots_[i].check.store(0, std::memory_order_relaxed);
+        slots_[i].data.store(0, std::memory_order_relaxed);
+    }
+    gen_ = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& out) const {
+    const Slot& s = slot(key);
+    uint64_t data  = s.data.load(std::memory_order_relaxed);
+    uint64_t check = s.check.load(std::memory_order_relaxed);
+    if (data == 0 || (check ^ data) != key) return false;
+
+    out.move.from  = (uint8_t)(data & 63);
+    out.move.to    = (uint8_t)((data >> 6) & 63);
+    out.move.promo = (uint8_t)((data >> 12) & 7);
+    out.bound      = (Bound)((data >> 22) & 3);
+    out.depth      = depth_of(data);
+    out.score      = (int)(int32_t)(uint32_t)(data >> 32);
+    return true;
+}
+
+void TranspositionTable::store(uint64_t key, const Move& m, int score, int depth, Bound bound) {
+    Slot& s = slot(key);
+    uint64_t old = s.data.load(std::memory_order_relaxed);
+    uint64_t old_key = s.check.load(std::memory_order_relaxed) ^ old;
+
+    // Keep a deeper entry from the current search for a different position
+    if (old != 0 && old_key != key && gen_of(old) == gen_ && depth_of(old) > depth) return;
+
+    // Same position: don't lose the best move to a move-less (fail-low) store
+    Move keep = m;
+    if (old != 0 && old_key == key && m == Move{}) {
+        keep.from  = (uint8_t)(old & 63);
+        keep.to    = (uint8_t)((old >> 6) & 63);
+        keep.promo = (uint8_t)((old >> 12) & 7);
+    }
+
+    uint64_t data = pack(keep, score, std::clamp(depth, 0, 255), bound, gen_);
+    s.data.store(data, std::memory_order_relaxed);
+    s.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::save(const std::string& path, std::string& err) const {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            err = "Cannot write " + tmp;
+            return false;
+        }
+
+        // The checksum goes in the header, so leave room and patch it in
+        unsigned char header[SNAPSHOT_HEADER] = {};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        uint64_t sum = 0;
+        std::vector<unsigned char> buf;
+        const std::size_t chunk = 4096;
+        for (std::size_t i = 0; i < count_; i += chunk) {
+            const std::size_t n = std::min(chunk, count_ - i);
+            buf.resize(n * SNAPSHOT_SLOT);
+            for (std::size_t j = 0; j < n; ++j) {
+                const uint64_t check = slots_[i + j].check.load(std::memory_order_relaxed);
+                const uint64_t data  = slots_[i + j].data.load(std::memory_order_relaxed);
+                put_le(&buf[j * SNAPSHOT_SLOT], check);
+                put_le(&buf[j * SNAPSHOT_SLOT + 8], data);
+                checksum_add(sum, check);
+                checksum_add(sum, data);
+            }
+            out.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size());
+        }
+
+        std::memcpy(header, SNAPSHOT_MAGIC, 4);
+        header[4] = SNAPSHOT_VERSION;
+        header[5] = (unsigned char)SNAPSHOT_SLOT;
+        header[6] = gen_;
+        put_le(header + 8, count_);
+        put_le(header + 16, zobrist_fingerprint());
+        put_le(header + 24, sum);
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        if (!out) {
+            err = "Write failed: " + tmp;
+            return false;
+        }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+        err = "Cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+bool TranspositionTable::load(const std::string& path, std::string& err) {
+    MappedFile file;
+    if (!file.open(path, err)) return false;
+
+    const unsigned char* h = file.data();
+    if (file.size() < SNAPSHOT_HEADER || std::memcmp(h, SNAPSHOT_MAGIC, 4) != 0) {
+        err = "Not a hash snapshot: " + path;
+        return false;
+    }
+    if (h[4] != SNAPSHOT_VERSION || h[5] != SNAPSHOT_SLOT) {
+        err = "Unsupported hash snapshot version: " + path;
+        return false;
+    }
+    if (get_le(h + 16) != zobrist_fingerprint()) {
+        err = "Hash snapshot was written with different hash keys: " + path;
+        return false;
+    }
+    const uint64_t n = get_le(h + 8);
+    if (n == 0 || (n & (n - 1)) != 0 || n > (file.size() - SNAPSHOT_HEADER) / SNAPSHOT_SLOT ||
+        file.size() != SNAPSHOT_HEADER + n * SNAPSHOT_SLOT) {
+        err = "Truncated hash snapshot: " + path;
+        return false;
+    }
+
+    const unsigned char* body = h + SNAPSHOT_HEADER;
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < 2 * n; ++i) checksum_add(sum, get_le(body + 8 * i));
+    if (sum != get_le(h + 24)) {
+        err = "Hash snapshot is corrupt (checksum mismatch): " + path;
+        return false;
+    }
+
+    // Only now touch the table, so a bad file leaves it as it was
+    clear();
+    gen_ = h[6] & 63;
+    for (uint64_t i = 0; i < n; ++i) {
+        const uint64_t check = get_le(body + i * SNAPSHOT_SLOT);
+        const uint64_t data  = get_le(body + i * SNAPSHOT_SLOT + 8);
+        if (data == 0) continue;
+
+        // Same size: slot i. Otherwise rehash by key, keeping the deeper entry.
+        Slot& s = (n == count_) ? slots_[i] : slot(check ^ data);
+        const uint64_t old = s.data.load(std::memory_order_relaxed);
+        if (old != 0 && depth_of(old) >= depth_of(data)) continue;
+        s.data.store(data, std::memory_order_relaxed);
+        s.check.store(check, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+int TranspositionTable::hashfull() const {
+    int used = 0;
+    std::size_t n = std::min<std::size_t>(1000, count_);
+    for (std::size_t i = 0; i < n; ++i) {
+        uint64_t d = slots_[i].data.load(std::memory_order_relaxed);
+        if (d != 0 && gen_of(d) == gen_) ++used;
+    }
+    return (int)(used * 1000 / n);
+}
+
+} // namespace chess
@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "dataset.hpp"
+#include "tuner.hpp"
+
+// Texel tuning of the evaluation weights:
+//   ichigo_tune [options] DATA.bin [DATA.bin ...]
+// The result is written in eval_weights.inc layout; copy it over
+// src/eval_weights.inc and rebuild.
+
+static void usage() {
+    std::cerr << "usage: ichigo_tune [options] DATA.bin [DATA.bin ...]\n"
+                 "  --epochs N         gradient steps (default 500)\n"
+                 "  --lr X             Adam step size in centipawns (default 1.0)\n"
+                 "  --k K              sigmoid scale (default: fitted to the data)\n"
+                 "  --lambda L         weight of the game result against the search score (default 1)\n"
+                 "  --threads N        default: all cores\n"
+                 "  --report N         print the error every N epochs (default 10)\n"
+                 "  --out FILE         default eval_weights.inc\n";
+}
+
+int main(int argc, char** argv) {
+    using namespace chess;
+
+    TunerOptions opts;
+    int epochs = 500, report = 10;
+    std::string out_path = "eval_weights.inc";
+    std::vector<std::string> inputs;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            if (a == "--epochs" && i + 1 < argc)       epochs = std::stoi(argv[++i]);
+            else if (a == "--lr" && i + 1 < argc)      opts.learning_rate = std::stod(argv[++i]);
+            else if (a == "--k" && i + 1 < argc)       opts.k = std::stod(argv[++i]);
+            else if (a == "--lambda" && i + 1 < argc)  opts.lambda = std::stod(argv[++i]);
+            else if (a == "--threads" && i + 1 < argc) opts.threads = std::stoi(argv[++i]);
+            else if (a == "--report" && i + 1 < argc)  report = std::max(1, std::stoi(argv[++i]));
+            else if (a == "--out" && i + 1 < argc)     out_path = argv[++i];
+            else if (a == "-h" || a == "--help")       { usage(); return 0; }
+            else if (a[0] != '-')                      inputs.push_back(a);
+            else                                       { usage(); return 1; }
+        }
+    } catch (...) {
+        usage();
+        return 1;
+    }
+    if (inputs.empty()) {
+        usage();
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    auto elapsed_s = [&]() {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    Tuner tuner(opts);
+    for (const std::string& path : inputs) {
+        Dataset ds;
+        std::string err;
+        if (!ds.open(path, err)) {
+            std::cerr << err << "\n";
+            return 1;
+        }
+        std::size_t n = tuner.load(ds);
+        std::fprintf(stderr, "%s: %zu positions\n", path.c_str(), n);
+    }
+    if (tuner.size() == 0) {
+        std::cerr << "No positions\n";
+        return 1;
+    }
+
+    if (opts.k <= 0) std::fprintf(stderr, "k = %.4f (fitted)\n", tuner.fit_k());
+    std::fprintf(stderr, "initial error %.6f\n", tuner.error());
+
+    tuner.train(epochs, [&](int epoch, double error) {
+        if (epoch % report == 0 || epoch == epochs)
+            std::fprintf(stderr, "epoch %d  error %.6f  (%.1fs)\n", epoch, error, elapsed_s());
+    });
+
+    std::ofstream out(out_path);
+    Tuner::write_weights(out, tuner.weights());
+    if (!out) {
+        std::cerr << "Cannot write " << out_path << "\n";
+        return 1;
+    }
+    std::fprintf(stderr, "final error %.6f, weights written to %s\n", tuner.error(), out_path.c_str());
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "tuner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <thread>
+
+namespace chess {
+
+Tuner::Tuner(const TunerOptions& opts) : opts_(opts), k_(opts.k > 0 ? opts.k : 1.0) {
+    const EvalWeights& init = Eval::weights();
+    w_.assign(init.w.begin(), init.w.end());
+    m_.assign(EvalWeights::COUNT, 0.0);
+    v_.assign(EvalWeights::COUNT, 0.0);
+}
+
+int Tuner::nthreads() const {
+    return opts_.threads > 0 ? opts_.threads : std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+double Tuner::sigmoid(double eval) const {
+    return 1.0 / (1.0 + std::pow(10.0, -k_ * eval / 400.0));
+}
+
+double Tuner::target(const Label& l) const {
+    if (opts_.lambda >= 1.0) return l.result;
+    return opts_.lambda * l.result + (1.0 - opts_.lambda) * sigmoid(l.score);
+}
+
+void Tuner::add(const Position& pos, double result, int score) {
+    EvalFeature buf[Eval::MAX_FEATURES];
+    int n = Eval::features(pos, buf);
+    features_.insert(features_.end(), buf, buf + n);
+    offsets_.push_back(features_.size());
+    labels_.push_back({(float)result, (float)score});
+}
+
+std::size_t Tuner::load(const Dataset& ds) {
+    // Each thread extracts one shard; the parts are appended in order
+    struct Part {
+        std::vector<EvalFeature> features;
+        std::vector<uint64_t> ends;
+        std::vector<Label> labels;
+    };
+    const int n = nthreads();
+    std::vector<Part> parts(n);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < n; ++t) {
+        pool.emplace_back([&, t]() {
+            Part& part = parts[t];
+            Position pos;
+            EvalFeature buf[Eval::MAX_FEATURES];
+            for (const DataRecord& r : ds.shard(t, n)) {
+                if (!r.pos.unpack(pos)) continue;
+                int k = Eval::features(pos, buf);
+                part.features.insert(part.features.end(), buf, buf + k);
+                part.ends.push_back(part.features.size());
+                part.labels.push_back({(float)(r.result + 1) / 2.0f, (float)r.score()});
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    std::size_t added = 0;
+    for (Part& part : parts) {
+        const uint64_t base = features_.size();
+        features_.insert(features_.end(), part.features.begin(), part.features.end());
+        for (uint64_t e : part.ends) offsets_.push_back(base + e);
+        labels_.insert(labels_.end(), part.labels.begin(), part.labels.end());
+        added += part.labels.size();
+    }
+    return added;
+}
+
+double Tuner::reduce(const std::function<double(std::size_t, std::size_t, double*)>& fn,
+                     std::vector<double>* grad) const {
+    const std::size_t total = size();
+    const int n = (int)std::min<std::size_t>((std::size_t)nthreads(), std::max<std::size_t>(1, total));
+    std::vector<double> errors(n, 0.0);
+    std::vector<std::vector<double>> grads(grad ? n : 0, std::vector<double>(EvalWeights::COUNT, 0.0));
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < n; ++t) {
+        pool.emplace_back([&, t]() {
+            const std::size_t begin = total * t / n, end = total * (t + 1) / n;
+            errors[t] = fn(begin, end, grad ? grads[t].data() : nullptr);
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    double err = 0.0;
+    for (double e : errors) err += e;
+    if (grad) {
+        grad->assign(EvalWeights::COUNT, 0.0);
+        for (const auto& g : grads)
+            for (int i = 0; i < EvalWeights::COUNT; ++i) (*grad)[i] += g[i];
+    }
+    return err;
+}
+
+double Tuner::error() const {
+    if (size() == 0) return 0.0;
+    double sum = reduce([this](std::size_t begin, std::size_t end, double*) {
+        double err = 0.0;
+        for (std::size_t i = begin; i < end; ++i) {
+            double e = 0.0;
+            for (uint64_t j = offsets_[i]; j < offsets_[i + 1]; ++j)
+                e += w_[features_[j].index] * features_[j].coef;
+            const double d = target(labels_[i]) - sigmoid(e);
+            err += d * d;
+        }
+        return err;
+    }, nullptr);
+    return sum / (double)size();
+}
+
+// Coarse-to-fine scan, one decimal place per round
+double Tuner::fit_k() {
+    double best = k_, best_err = error();
+    double lo = 0.0, hi = 10.0, step = 1.0;
+    for (int round = 0; round < 4; ++round) {
+        for (double k = lo; k <= hi + 1e-9; k += step) {
+            if (k <= 0.0) continue;
+            k_ = k;
+            double e = error();
+            if (e < best_err) {
+                best_err = e;
+                best = k;
+            }
+        }
+        lo = best - step;
+        hi = best + step;
+        step /= 10.0;
+    }
+    k_ = best;
+    return k_;
+}
+
+void Tuner::train(int epochs, const Progress& progress) {
+    if (size() == 0) return;
+    constexpr double BETA1 = 0.9, BETA2 = 0.999, EPS = 1e-8;
+    const double scale = k_ * std::log(10.0) / 400.0;
+    std::vector<double> grad;
+
+    for (int epoch = 1; epoch <= epochs; ++epoch) {
+        double sum = reduce([&](std::size_t begin, std::size_t end, double* g) {
+            double err = 0.0;
+            for (std::size_t i = begin; i < end; ++i) {
+                double e = 0.0;
+                for (uint64_t j = offsets_[i]; j < offsets_[i + 1]; ++j)
+                    e += w_[features_[j].index] * features_[j].coef;
+                const double s = sigmoid(e);
+                const double d = target(labels_[i]) - s;
+                err += d * d;
+                const double de = -2.0 * d * s * (1.0 - s) * scale;
+                for (uint64_t j = offsets_[i]; j < offsets_[i + 1]; ++j)
+                    g[features_[j].index] += de * features_[j].coef;
+            }
+            return err;
+        }, &grad);
+
+        ++step_;
+        const double n = (double)size();
+        const double c1 = 1.0 - std::pow(BETA1, step_), c2 = 1.0 - std::pow(BETA2, step_);
+        for (int i = 0; i < EvalWeights::COUNT; ++i) {
+            const double g = grad[i] / n;
+            m_[i] = BETA1 * m_[i] + (1.0 - BETA1) * g;
+            v_[i] = BETA2 * v_[i] + (1.0 - BETA2) * g * g;
+            w_[i] -= opts_.learning_rate * (m_[i] / c1) / (std::sqrt(v_[i] / c2) + EPS);
+        }
+        if (progress) progress(epoch, sum / n);
+    }
+}
+
+EvalWeights Tuner::weights() const {
+    EvalWeights out;
+    for (int i = 0; i < EvalWeights::COUNT; ++i) out.w[i] = (int)std::lround(w_[i]);
+    return out;
+}
+
+void Tuner::write_weights(std::ostream& out, const EvalWeights& w) {
+    static const char* names[6] = {"pawn", "knight", "bishop", "rook", "queen", "king"};
+    out << "// Evaluation weights (see EvalWeights), written by ichigo_tune.\n";
+    out << "// Material: P N B R Q K\n";
+    for (int t = 0; t < 6; ++t) out << w.w[EvalWeights::MATERIAL + t] << (t < 5 ? ", " : ",\n");
+    for (int t = 0; t < 6; ++t) {
+        out << "// " << names[t] << ", a1..h8\n";
+        for (int r = 0; r < 8; ++r) {
+            for (int f = 0; f < 8; ++f)
+                out << w.w[EvalWeights::pst_index(t, r * 8 + f)] << (f < 7 ? ", " : ",\n");
+        }
+    }
+}
+
+} // namespace chess
@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "book.hpp"
+#include "engine.hpp"
+#include "parse.hpp"
+#include "position.hpp"
+#include "render.hpp"
+#include "tablebase.hpp"
+
+// UCI front-end. Commands are read on the main thread while the Engine
+// searches on its own threads, so "stop" and "isready" are answered at once.
+
+namespace {
+
+std::mutex out_mu;
+
+void send(const std::string& line) {
+    std::lock_guard<std::mutex> lock(out_mu);
+    std::cout << line << std::endl;
+}
+
+// UCI scores are from the side to move's point of view.
+std::string score_str(int white_score, chess::Color stm) {
+    int s = (stm == chess::Color::White) ? white_score : -white_score;
+    if (chess::is_mate_score(s)) {
+        int plies = chess::MATE_SCORE - std::abs(s);
+        int moves = (s > 0) ? (plies + 1) / 2 : -(plies / 2);
+        return "mate " + std::to_string(moves);
+    }
+    return "cp " + std::to_string(s);
+}
+
+std::string info_str(const chess::SearchInfo& info, chess::Color stm, int hashfull, bool multipv) {
+    std::ostringstream out;
+    uint64_t nps = info.time_ms > 0 ? info.nodes * 1000 / (uint64_t)info.time_ms : info.nodes;
+    out << "info";
+    if (!info.pv.empty()) {
+        if (multipv) out << " multipv " << info.multipv;
+        out << " depth " << info.depth << " seldepth " << info.seldepth
+            << " score " << score_str(info.score, stm);
+    }
+    out << " nodes " << info.nodes << " nps " << nps << " time " << info.time_ms;
+    if (!info.pv.empty()) {
+        out << " hashfull " << hashfull << " pv";
+        for (const auto& m : info.pv) out << " " << chess::Render::move_uci(m);
+    }
+    return out.str();
+}
+
+// position startpos|fen <fen> [moves m1 m2 ...]
+// history receives the keys of the positions before the final one.
+bool parse_position(std::istringstream& in, chess::Position& pos, std::vector<uint64_t>& history) {
+    using namespace chess;
+
+    history.clear();
+    std::string tok;
+    in >> tok;
+    if (tok == "startpos") {
+        pos = Position::startpos();
+        in >> tok;
+    } else if (tok == "fen") {
+        std::string fen, part;
+        while (in >> part && part != "moves") fen += part + " ";
+        auto parsed = Parse::fen(fen);
+        if (!parsed) {
+            send("info string invalid fen");
+            return false;
+        }
+        pos = *parsed;
+        tok = part;
+    } else {
+        return false;
+    }
+
+    if (tok != "moves") return true;
+
+    while (in >> tok) {
+        auto m = Parse::uci_move(tok);
+        std::string err;
+        const uint64_t key = pos.key();
+        if (!m || !pos.make_move(*m, err)) {
+            send("info string illegal move " + tok);
+            return false;
+        }
+        history.push_back(key);
+    }
+    return true;
+}
+
+chess::SearchLimits parse_go(std::istringstream& in) {
+    chess::SearchLimits limits;
+    std::string tok;
+    while (in >> tok) {
+        if (tok == "depth")          in >> limits.depth;
+        else if (tok == "nodes")     in >> limits.nodes;
+        else if (tok == "movetime")  in >> limits.movetime_ms;
+        else if (tok == "wtime")     in >> limits.wtime_ms;
+        else if (tok == "btime")     in >> limits.btime_ms;
+        else if (tok == "winc")      in >> limits.winc_ms;
+        else if (tok == "binc")      in >> limits.binc_ms;
+        else if (tok == "movestogo") in >> limits.movestogo;
+        else if (tok == "infinite")  limits.infinite = true;
+        else if (tok == "ponder")    limits.ponder = true;
+    }
+    return limits;
+}
+
+struct SearchOptions {
+    int multipv = 1;
+    std::string hash_file;
+};
+
+struct BookOptions {
+    chess::Book book;
+    bool own_book = false;
+    std::mt19937_64 rng{std::random_device{}()};
+};
+
+void load_tablebase(const std::string& dir, chess::Engine& engine, chess::Tablebase& tb) {
+    engine.set_tablebase(nullptr);
+    tb.clear();
+    if (dir.empty() || dir == "<empty>") return;
+
+    std::string err;
+    if (!tb.load_dir(dir, err)) {
+        send("info string " + err);
+        return;
+    }
+    engine.set_tablebase(&tb);
+    send("info string " + std::to_string(tb.count()) + " tables loaded");
+}
+
+// setoption name <id> [value <x>]
+void parse_setoption(std::istringstream& in, chess::Engine& engine, SearchOptions& so, BookOptions& bo,
+                     chess::Tablebase& tb) {
+    std::string tok, name, value;
+    in >> tok; // "name"
+    while (in >> tok && tok != "value") name += (name.empty() ? "" : " ") + tok;
+    std::getline(in >> std::ws, value);
+
+    try {
+        if (name == "Hash") {
+            engine.set_hash_mb((std::size_t)std::max(1, std::stoi(value)));
+        } else if (name == "Threads") {
+            engine.set_threads(std::max(1, std::stoi(value)));
+        } else if (name == "HashFile") {
+            so.hash_file = (value == "<empty>") ? "" : value;
+        } else if (name == "Save Hash" || name == "Load Hash") {
+            std::string err;
+            const bool save = (name == "Save Hash");
+            if (so.hash_file.empty()) send("info string HashFile is not set");
+            else if (save ? engine.save_hash(so.hash_file, err) : engine.load_hash(so.hash_file, err))
+                send(std::string("info string hash ") + (save ? "saved to " : "loaded from ") + so.hash_file);
+            else send("info string " + err);
+        } else if (name == "MultiPV") {
+            so.multipv = std::clamp(std::stoi(value), 1, 256);
+        } else if (name == "Ponder") {
+            // Nothing to configure: pondering is driven by "go ponder"
+        } else if (name == "OwnBook") {
+            bo.own_book = (value == "true");
+        } else if (name == "BookFile") {
+            std::string err;
+            if (value.empty() || value == "<empty>") bo.book.close();
+            else if (!bo.book.open(value, err)) send("info string " + err);
+            else send("info string book loaded, " + std::to_string(bo.book.size()) + " entries");
+        } else if (name == "TablebasePath") {
+            load_tablebase(value, engine, tb);
+        } else {
+            send("info string unknown option " + name);
+        }
+    } catch (...) {
+        send("info string invalid value for " + name);
+    }
+}
+
+} // namespace
+
+int main() {
+    using namespace chess;
+
+    Tablebase tb;   // outlives the engine that probes it
+    Engine engine;
+    SearchOptions so;
+    BookOptions bo;
+    Position pos = Position::startpos();
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string cmd;
+        in >> cmd;
+
+        if (cmd == "uci") {
+            send("id name Ichigo");
+            send("id author Ichigo developers");
+            send("option name Hash type spin default 16 min 1 max 4096");
+            send("option name Threads type spin default 1 min 1 max 256");
+            send("option name HashFile type string default <empty>");
+            send("option name Save Hash type button");
+            send("option name Load Hash type button");
+            send("option name MultiPV type spin default 1 min 1 max 256");
+            send("option name Ponder type check default false");
+            send("option name OwnBook type check default false");
+            send("option name BookFile type string default <empty>");
+            send("option name TablebasePath type string default <empty>");
+            send("uciok");
+        } else if (cmd == "isready") {
+            send("readyok");
+        } else if (cmd == "setoption") {
+            engine.stop();
+            parse_setoption(in, engine, so, bo, tb);
+        } else if (cmd == "ucinewgame") {
+            engine.stop();
+            engine.new_game();
+            engine.set_game_history({});
+            pos = Position::startpos();
+        } else if (cmd == "position") {
+            engine.stop();
+            engine.wait();
+            std::vector<uint64_t> history;
+            parse_position(in, pos, history);
+            engine.set_game_history(history);
+        } else if (cmd == "go") {
+            engine.stop();
+            SearchLimits limits = parse_go(in);
+            limits.multipv = so.multipv;
+            const Color stm = pos.side_to_move();
+            const bool multipv = so.multipv > 1;
+
+            // Book moves are answered straight away, without searching
+            if (bo.own_book && bo.book.is_open() && !limits.infinite && !limits.ponder) {
+                if (auto bm = bo.book.pick(pos, bo.rng)) {
+                    // Suggest the book's main reply to ponder on, if it has one
+                    std::string line = "bestmove " + Render::move_uci(*bm);
+                    Position next = pos;
+                    std::string err;
+                    if (next.make_move(*bm, err)) {
+                        auto replies = bo.book.entries(next);
+                        if (!replies.empty()) line += " ponder " + Render::move_uci(replies.front().move);
+                    }
+                    send("info string book move");
+                    send(line);
+                    continue;
+                }
+            }
+
+            engine.go(pos, limits,
+                [&engine, stm, multipv](const SearchInfo& info) {
+                    send(info_str(info, stm, info.pv.empty() ? 0 : engine.hashfull(), multipv));
+                },
+                [](const SearchResult& res) {
+                    std::string line = "bestmove " + ((res.best == Move{}) ? "0000" : Render::move_uci(res.best));
+                    // The expected reply, so a GUI can start "go ponder" on it
+                    if (res.pv.size() >= 2) line += " ponder " + Render::move_uci(res.pv[1]);
+                    send(line);
+                });
+        } else if (cmd == "ponderhit") {
+            engine.ponderhit();
+        } else if (cmd == "stop") {
+            engine.stop();
+        } else if (cmd == "quit") {
+            break;
+        } else if (cmd == "d") {
+            std::lock_guard<std::mutex> lock(out_mu);
+            std::cout << Render::board_ascii(pos) << std::flush;
+        }
+    }
+
+    engine.stop();
+    engine.wait();
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <cassert>
+#include <iostream>
+
+#include "annotate.hpp"
+#include "parse.hpp"
+#include "pgn.hpp"
+
+using namespace chess;
+
+static std::vector<Move> san_line(Position pos, std::initializer_list<const char*> sans) {
+    std::vector<Move> out;
+    std::string err;
+    for (const char* s : sans) {
+        auto m = Parse::san(pos, s);
+        assert(m);
+        pos.make_move(*m, err);
+        out.push_back(*m);
+    }
+    return out;
+}
+
+int main() {
+    const Position start = Position::startpos();
+
+    // Scholar's mate: 4...Nf6?? allows Qxf7#
+    const std::vector<Move> game =
+        san_line(start, {"e4", "e5", "Qh5", "Nc6", "Bc4", "Nf6", "Qxf7#"});
+
+    for (bool reverse : {false, true}) {
+        AnnotateOptions opts;
+        opts.limits.depth = 3;
+        opts.hash_mb = 4;
+        opts.reverse = reverse;
+        Annotator annotator(opts);
+
+        std::size_t calls = 0;
+        auto plies = annotator.analyze(start, game, [&](std::size_t done, std::size_t total) {
+            ++calls;
+            assert(done == calls && total == game.size() + 1);
+        });
+        assert(plies.size() == game.size());
+        assert(annotator.nodes() > 0);
+
+        // The blunder and the punishment
+        const PlyAnalysis& blunder = plies[5];
+        assert(blunder.swing >= 300 && Annotator::judgement(blunder.swing) == "??");
+        assert(is_mate_score(blunder.score_after) && blunder.score_after > 0);
+
+        const PlyAnalysis& mate = plies[6];
+        assert(mate.best == mate.played);
+        assert(Annotator::judgement(mate.swing).empty());
+
+        // Quiet opening moves are not flagged
+        assert(Annotator::judgement(plies[0].swing).empty());
+    }
+
+    // State kept between positions beats searching each one from scratch
+    {
+        const std::vector<Move> line = san_line(start, {"e4", "e5", "Nf3", "Nc6", "Bb5", "a6",
+                                                        "Ba4", "Nf6", "O-O", "Be7"});
+        AnnotateOptions opts;
+        opts.limits.depth = 5;
+        opts.hash_mb = 4;
+        Annotator annotator(opts);
+        annotator.analyze(start, line);
+
+        uint64_t separate = 0;
+        Position pos = start;
+        std::string err;
+        for (std::size_t i = 0; i <= line.size(); ++i) {
+            TranspositionTable tt(opts.hash_mb);
+            Searcher cold(tt);
+            separate += cold.search(pos, opts.limits).nodes;
+            if (i < line.size()) pos.make_move(line[i], err);
+        }
+        assert(annotator.nodes() < separate);
+    }
+
+    // Annotated PGN reads back as the same game
+    {
+        AnnotateOptions opts;
+        opts.limits.depth = 2;
+        opts.hash_mb = 4;
+        Annotator annotator(opts);
+        auto plies = annotator.analyze(start, game);
+
+        PgnGame g;
+        g.moves = game;
+        g.result = "1-0";
+        g.tags = {{"Event", "Test"}, {"Result", "?"}};
+
+        std::vector<std::string> notes;
+        Position pos = start;
+        std::string err;
+        int number = 1;
+        for (const PlyAnalysis& a : plies) {
+            notes.push_back(Annotator::pgn_comment(pos, a, number));
+            if (pos.side_to_move() == Color::Black) ++number;
+            pos.make_move(a.played, err);
+        }
+
+        std::string text = Pgn::write(g, notes);
+        assert(text.find("[Result \"1-0\"]") != std::string::npos);
+        assert(text.find("Nf6 $4") != std::string::npos);
+        assert(text.find("(3...") != std::string::npos);
+
+        PgnGame back;
+        bool ok = Pgn::parse_game(text, back, err);
+        if (!ok) std::cerr << err << "\n" << text;
+        assert(ok);
+        assert(back.moves == game);
+        assert(back.result == "1-0");
+    }
+
+    std::cout << "test_annotate: OK\n";
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <cassert>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "batch.hpp"
+
+using namespace chess;
+
+static std::vector<std::string> lines_of(const std::string& s) {
+    std::vector<std::string> out;
+    std::istringstream in(s);
+    for (std::string l; std::getline(in, l);) out.push_back(l);
+    return out;
+}
+
+int main() {
+    const std::string input =
+        "6k1/5ppp/8/8/8/8/1Q6/K7 w - - bm Qb8#; id \"mate1\";\n"
+        "\n"
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+        "not a position\n"
+        "4k3/8/8/8/8/8/8/R3K3 b - - id \"lost\";\n"
+        "3qk3/8/8/8/8/8/8/3RK3 w - - 0 1\n";
+
+    // 1) One output line per position, in input order, whatever the pool size
+    std::string reference;
+    for (int threads : {1, 3}) {
+        BatchOptions opts;
+        opts.limits.depth = 3;
+        opts.threads = threads;
+        opts.hash_mb = 1;
+        opts.window = 2;   // forces the reader to wait on the writer
+
+        std::istringstream in(input);
+        std::ostringstream out;
+        uint64_t n = Batch::analyze(in, out, opts);
+        assert(n == 5);
+
+        auto lines = lines_of(out.str());
+        assert(lines.size() == 5);
+        assert(lines[0].rfind("6k1/5ppp/8/8/8/8/1Q6/K7 w - -", 0) == 0);
+        assert(lines[0].find("bm Qb8#;") != std::string::npos);
+        assert(lines[0].find("dm 1;") != std::string::npos);
+        assert(lines[0].find("id \"mate1\"") != std::string::npos);
+        assert(lines[1].rfind("rnbqkbnr/", 0) == 0 && lines[1].find("acd 3;") != std::string::npos);
+        assert(lines[2].find("c0 \"invalid position\"") != std::string::npos);
+        assert(lines[3].find("id \"lost\"") != std::string::npos);
+        assert(lines[4].find("bm Rxd8+;") != std::string::npos);
+
+        // Per-position state is reset: results don't depend on scheduling
+        if (reference.empty()) reference = out.str();
+        else assert(out.str() == reference);
+    }
+
+    // 2) Scores are from the side to move
+    {
+        TranspositionTable tt(1);
+        Searcher s(tt);
+        SearchLimits l;
+        l.depth = 2;
+        std::string r = Batch::analyze_line("4k3/8/8/8/8/8/8/Q3K3 b - -", s, tt, l);
+        std::size_t ce = r.find(" ce ");
+        assert(ce != std::string::npos && r[ce + 4] == '-');
+    }
+
+    // 3) A full six-field FEN keeps its halfmove clock: with 99 plies gone
+    //    and no mate in one, every line is a fifty-move draw
+    {
+        TranspositionTable tt(1);
+        Searcher s(tt);
+        SearchLimits l;
+        l.depth = 4;
+        std::string fresh = Batch::analyze_line("8/8/8/4k3/8/8/8/R3K3 w - - 0 80", s, tt, l);
+        std::string late = Batch::analyze_line("8/8/8/4k3/8/8/8/R3K3 w - - 99 80", s, tt, l);
+        assert(fresh.find(" ce 0;") == std::string::npos);
+        assert(late.find(" ce 0;") != std::string::npos);
+    }
+
+    // 4) id is matched as an opcode, not inside other operations or strings
+    {
+        TranspositionTable tt(1);
+        Searcher s(tt);
+        SearchLimits l;
+        l.depth = 1;
+        std::string r = Batch::analyze_line(
+            "4k3/8/8/8/8/8/8/R3K3 w - - c0 \"no id here; really\"; pid 7; id \"real\";", s, tt, l);
+        assert(r.find(" id \"real\";") != std::string::npos);
+        assert(r.find("here") == std::string::npos);
+        r = Batch::analyze_line("4k3/8/8/8/8/8/8/R3K3 w - - c0 \"id x\";", s, tt, l);
+        assert(r.find("id") == std::string::npos);
+    }
+
+    std::cout << "test_batch: OK\n";
+    return 0;
+}
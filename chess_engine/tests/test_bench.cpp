@@ -0,0 +1,29 @@
+#include <cassert>
+#include <iostream>
+
+#include "bench.hpp"
+#include "parse.hpp"
+#include "rules.hpp"
+
+using namespace chess;
+
+int main() {
+    // Every built-in position is legal: parses, and the side that just
+    // moved is not left in check
+    assert(Bench::positions().size() >= 40);
+    for (const auto& fen : Bench::positions()) {
+        auto pos = Parse::fen(fen);
+        assert(pos);
+        assert(!Rules::in_check(*pos, other(pos->side_to_move())));
+    }
+
+    // The node count is a signature: identical run to run
+    BenchResult a = Bench::run(2);
+    BenchResult b = Bench::run(2);
+    assert(a.positions == (int)Bench::positions().size());
+    assert(a.nodes > 0);
+    assert(a.nodes == b.nodes);
+
+    std::cout << "test_bench passed (" << a.nodes << " nodes at depth 2)\n";
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#include "support/testutil.hpp"
+#include "book.hpp"
+#include "parse.hpp"
+
+using namespace chess;
+using namespace test;
+
+struct RawEntry {
+    uint64_t key;
+    uint16_t move;
+    uint16_t weight;
+};
+
+static void put_be(std::ofstream& out, uint64_t v, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) out.put((char)((v >> (8 * i)) & 0xFF));
+}
+
+static std::string write_book(std::vector<RawEntry> es) {
+    std::sort(es.begin(), es.end(), [](const RawEntry& a, const RawEntry& b) { return a.key < b.key; });
+    std::string path = "test_book_tmp.bin";
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& e : es) {
+        put_be(out, e.key, 8);
+        put_be(out, e.move, 2);
+        put_be(out, e.weight, 2);
+        put_be(out, 0, 4);
+    }
+    return path;
+}
+
+int main() {
+    Position start = Position::startpos();
+
+    // 1) Move encoding round-trips, castling goes through king-takes-rook
+    {
+        auto pos = Parse::fen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+        assert(pos);
+        uint16_t oo = Book::encode_move(*pos, MV("e1", "g1"));
+        assert(Book::decode_move(*pos, oo) == MV("e1", "g1"));
+        assert(((oo & 7) == 7) && (((oo >> 3) & 7) == 0));   // encoded as e1h1
+
+        uint16_t ooo = Book::encode_move(*pos, MV("e1", "c1"));
+        assert(Book::decode_move(*pos, ooo) == MV("e1", "c1"));
+
+        auto promo = Parse::fen("8/P6k/8/8/8/8/7K/8 w - - 0 1");
+        assert(promo);
+        Move m = MV("a7", "a8", 'n');
+        assert(Book::decode_move(*promo, Book::encode_move(*promo, m)) == m);
+    }
+
+    // 2) The ep file only enters the key when the capture is possible
+    {
+        Position a = start;
+        std::string err;
+        a.make_move(MV("e2", "e4"), err);
+        Position b = a;
+        b.set_ep_square(-1);
+        assert(Book::key(a) == Book::key(b));   // no black pawn next to e4
+
+        auto c = Parse::fen("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+        auto d = Parse::fen("rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+        assert(c && d);
+        assert(Book::key(*c) != Book::key(*d));
+    }
+
+    // 2b) Keys match the reference values from the Polyglot specification
+    {
+        struct Known { const char* moves; uint64_t key; };
+        const Known known[] = {
+            {"", 0x463b96181691fc9cULL},
+            {"e2e4", 0x823c9b50fd114196ULL},
+            {"e2e4 d7d5", 0x0756b94461c50fb0ULL},
+            {"e2e4 d7d5 e4e5", 0x662fafb965db29d4ULL},
+            {"e2e4 d7d5 e4e5 f7f5", 0x22a48b5a8e47ff78ULL},
+            {"e2e4 d7d5 e4e5 f7f5 e1e2", 0x652a607ca3f242c1ULL},
+            {"e2e4 d7d5 e4e5 f7f5 e1e2 e8f7", 0x00fdd303c946bdd9ULL},
+            {"a2a4 b7b5 h2h4 b5b4 c2c4", 0x3c8123ea7b067637ULL},
+            {"a2a4 b7b5 h2h4 b5b4 c2c4 b4c3 a1a3", 0x5c3f9b829b279560ULL},
+        };
+        for (const Known& k : known) {
+            Position pos = start;
+            std::istringstream in(k.moves);
+            std::string uci, err;
+            while (in >> uci) {
+                bool ok = pos.make_move(*Parse::uci_move(uci), err);
+                assert(ok);
+            }
+            assert(Book::key(pos) == k.key);
+        }
+    }
+
+    // 3) Probing: binary search finds only this position's entries, sorted by
+    //    weight; illegal entries are dropped; weighted pick stays in book
+    {
+        Position after_e4 = start;
+        std::string err;
+        after_e4.make_move(MV("e2", "e4"), err);
+
+        std::vector<RawEntry> es;
+        es.push_back({Book::key(start), Book::encode_move(start, MV("e2", "e4")), 10});
+        es.push_back({Book::key(start), Book::encode_move(start, MV("d2", "d4")), 30});
+        es.push_back({Book::key(start), Book::encode_move(start, MV("e2", "e5")), 50}); // illegal
+        es.push_back({Book::key(after_e4), Book::encode_move(after_e4, MV("c7", "c5")), 5});
+        for (uint64_t k = 1; k < 200; ++k) es.push_back({k * 0x9E3779B97F4A7C15ULL, 0, 1});
+
+        std::string path = write_book(es);
+        Book book;
+        std::string berr;
+        bool ok = book.open(path, berr);
+        if (!ok) std::cerr << berr << "\n";
+        assert(ok);
+        assert(book.size() == es.size());
+
+        auto found = book.entries(start);
+        assert(found.size() == 2);
+        assert(found[0].move == MV("d2", "d4") && found[0].weight == 30);
+        assert(found[1].move == MV("e2", "e4"));
+
+        auto reply = book.entries(after_e4);
+        assert(reply.size() == 1 && reply[0].move == MV("c7", "c5"));
+
+        std::mt19937_64 rng(1);
+        int d4 = 0;
+        for (int i = 0; i < 400; ++i) {
+            auto m = book.pick(start, rng);
+            assert(m && (*m == MV("d2", "d4") || *m == MV("e2", "e4")));
+            if (*m == MV("d2", "d4")) ++d4;
+        }
+        assert(d4 > 200 && d4 < 380);   // ~75% by weight
+
+        Position other = start;
+        other.make_move(MV("g1", "f3"), err);
+        assert(!book.pick(other, rng));
+
+        book.close();
+        std::remove(path.c_str());
+    }
+
+    // 4) Missing file is an error, not a crash
+    {
+        Book book;
+        std::string err;
+        assert(!book.open("does_not_exist.bin", err));
+        assert(!err.empty());
+    }
+
+    std::cout << "test_book: OK\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+
+#include "datagen.hpp"
+#include "dataset.hpp"
+#include "rules.hpp"
+
+using namespace chess;
+
+int main() {
+    const std::string path = "test_datagen_tmp.bin";
+
+    DatagenOptions opts;
+    opts.output = path;
+    opts.games = 6;
+    opts.threads = 2;
+    opts.nodes = 300;
+    opts.hash_mb = 1;
+    opts.max_plies = 120;
+    opts.dedup_mb = 1;
+    opts.seed = 7;
+
+    Datagen gen(opts);
+    std::string err;
+    int reports = 0;
+    assert(gen.run(err, [&](const DatagenStats&) { ++reports; }));
+
+    const DatagenStats& st = gen.stats();
+    assert(st.games == 6 && reports == 6);
+    assert(st.white_wins + st.draws + st.black_wins == st.games);
+    assert(st.positions > 0);
+
+    // Every record is a distinct quiet position with a sane label
+    Dataset ds;
+    assert(ds.open(path, err));
+    assert(ds.size() == st.positions);
+    std::set<uint64_t> keys;
+    for (const DataRecord& r : ds.records()) {
+        Position pos;
+        assert(r.pos.unpack(pos));
+        assert(!Rules::in_check(pos, pos.side_to_move()));
+        assert(r.result >= -1 && r.result <= 1);
+        assert(keys.insert(pos.key()).second);
+    }
+    ds.close();
+
+    // A position budget stops the run early
+    opts.games = 1000;
+    opts.positions = 50;
+    Datagen capped(opts);
+    assert(capped.run(err));
+    assert(capped.stats().positions == 50 && capped.stats().games < 1000);
+    assert(ds.open(path, err) && ds.size() == 50);
+    ds.close();
+
+    std::remove(path.c_str());
+
+    // A filter fed far more keys than it holds: no new key is ever
+    // dropped, recent keys are still caught and the oldest are forgotten
+    {
+        KeyFilter filter(64 * 64);   // 64 buckets
+        assert(filter.capacity() == 64 * KeyFilter::WAYS);
+
+        const std::size_t n = filter.capacity() * 16;
+        std::vector<uint64_t> keys;
+        std::set<uint64_t> distinct;
+        std::mt19937_64 rng(11);
+        while (keys.size() < n) {
+            uint64_t k = rng();
+            if (k && distinct.insert(k).second) keys.push_back(k);
+        }
+        for (uint64_t k : keys) assert(filter.insert(k));
+
+        std::size_t caught = 0;
+        for (std::size_t i = n - 64; i < n; ++i) caught += !filter.insert(keys[i]);
+        assert(caught == 64);   // one per bucket on average: nowhere near full
+
+        std::size_t forgotten = 0;
+        for (std::size_t i = 0; i < filter.capacity(); ++i) forgotten += filter.insert(keys[i]);
+        assert(forgotten == filter.capacity());
+
+        // A key that keeps coming back stays however many others pass
+        KeyFilter hot(64 * 64);
+        assert(hot.insert(42));
+        for (std::size_t i = 0; i < n; ++i) {
+            hot.insert(keys[i]);
+            if (i % 4 == 0) assert(!hot.insert(42));
+        }
+    }
+
+    std::cout << "test_datagen: OK\n";
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "dataset.hpp"
+#include "movegen.hpp"
+#include "packed.hpp"
+#include "parse.hpp"
+#include "render.hpp"
+
+using namespace chess;
+
+int main() {
+    // Bench positions and their children survive pack/unpack unchanged
+    std::vector<Position> corpus;
+    for (const std::string& fen : Bench::positions()) {
+        auto pos = Parse::fen(fen);
+        assert(pos);
+        corpus.push_back(*pos);
+        MoveList ml;
+        MoveGen::generate_legal(*pos, ml);
+        std::string err;
+        for (int i = 0; i < ml.size; ++i) {
+            Position child = *pos;
+            if (child.make_move(ml.moves[i], err)) corpus.push_back(child);
+        }
+    }
+    for (const Position& pos : corpus) {
+        PackedPosition pp;
+        assert(PackedPosition::pack(pos, pp));
+        Position back;
+        assert(pp.unpack(back));
+        assert(back.key() == pos.key());
+        assert(Render::fen(back) == Render::fen(pos));
+    }
+
+    // Malformed data is rejected
+    {
+        PackedPosition pp;
+        assert(PackedPosition::pack(Position::startpos(), pp));
+        PackedPosition bad = pp;
+        bad.bytes[8] = 0x0F;   // piece code 15
+        Position p;
+        assert(!bad.unpack(p));
+        bad = pp;
+        bad.bytes[25] = 64;
+        assert(!bad.unpack(p));
+    }
+
+    // Write a dataset, then read it back in place, by index and by shard
+    const std::string path = "test_dataset_tmp.bin";
+    {
+        DatasetWriter w;
+        std::string err;
+        assert(w.open(path, err));
+        for (std::size_t i = 0; i < corpus.size(); ++i)
+            assert(w.write(corpus[i], (int)i - 500, (int)(i % 3) - 1));
+        assert(w.close(err));
+        assert(w.count() == corpus.size());
+    }
+    {
+        Dataset ds;
+        std::string err;
+        assert(ds.open(path, err));
+        assert(ds.size() == corpus.size());
+
+        const std::size_t i = corpus.size() / 2;
+        Position p;
+        assert(ds[i].pos.unpack(p) && p.key() == corpus[i].key());
+        assert(ds[i].score() == (int)i - 500 && ds[i].result == (int)(i % 3) - 1);
+
+        std::size_t covered = 0;
+        const DataRecord* expect = ds.records().data();
+        for (int s = 0; s < 7; ++s) {
+            auto shard = ds.shard(s, 7);
+            assert(shard.data() == expect);
+            expect += shard.size();
+            covered += shard.size();
+        }
+        assert(covered == ds.size());
+    }
+
+    // Scores beyond 16 bits are clamped
+    {
+        DataRecord r;
+        r.set_score(100000);
+        assert(r.score() == 32767);
+        r.set_score(-5);
+        assert(r.score() == -5);
+    }
+
+    // Text samples: opcodes match whole, results are whole tokens
+    {
+        Position pos;
+        int score = 7, result = 7;
+        const std::string epd = "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq -";
+
+        assert(DatasetWriter::parse_text(epd, pos, score, result));
+        assert(score == 0 && result == 0 && pos.side_to_move() == Color::Black);
+
+        // ce is the side to move's score; c9 carries the result
+        assert(DatasetWriter::parse_text(epd + " ce 35; c9 \"0-1\";", pos, score, result));
+        assert(score == -35 && result == -1);
+
+        // Bare result tokens, before or after the operations, and full FENs
+        assert(DatasetWriter::parse_text(epd + " 1-0 ce -20;", pos, score, result));
+        assert(score == 20 && result == 1);
+        assert(DatasetWriter::parse_text(epd + " ce 10; 0-1", pos, score, result));
+        assert(score == -10 && result == -1);
+        assert(DatasetWriter::parse_text(
+            "4k3/8/8/8/8/8/4P3/4K3 w - - 3 40 1/2-1/2 ce 55;", pos, score, result));
+        assert(score == 55 && result == 0 && pos.halfmove_clock() == 3);
+
+        // "ce " inside other operations and results inside ids or
+        // comments are not read
+        assert(DatasetWriter::parse_text(
+            epd + " id \"race 1-0\"; c0 \"see ce 300; 0-1\"; acn 100;", pos, score, result));
+        assert(score == 0 && result == 0);
+        assert(DatasetWriter::parse_text(epd + " pce 99; c9 \"11-0\";", pos, score, result));
+        assert(score == 0 && result == 0);
+
+        // A ce operand that is not a number, or no position at all
+        assert(!DatasetWriter::parse_text(epd + " ce 12x;", pos, score, result));
+        assert(!DatasetWriter::parse_text("ce 35; 1-0", pos, score, result));
+    }
+
+    // Wrong magic and truncated files are errors
+    {
+        { std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a dataset file"; }
+        Dataset ds;
+        std::string err;
+        assert(!ds.open(path, err) && !err.empty());
+    }
+    std::remove(path.c_str());
+
+    std::cout << "test_dataset: OK\n";
+    return 0;
+}
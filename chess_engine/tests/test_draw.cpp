@@ -0,0 +1,75 @@
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#include "gamestate.hpp"
+#include "parse.hpp"
+#include "support/testutil.hpp"
+
+using namespace chess;
+using test::MV;
+
+// Plays "e2 e4"-style moves, recording the key of each position left behind.
+static void play(Position& pos, std::vector<uint64_t>& history, std::initializer_list<const char*> moves) {
+    for (const char* m : moves) {
+        std::string err;
+        const uint64_t key = pos.key();
+        bool ok = pos.make_move(MV(std::string(m, 2), m + 3), err);
+        assert(ok);
+        history.push_back(key);
+    }
+}
+
+int main() {
+    // Halfmove clock: reset by pawn moves and captures, read from FEN
+    {
+        Position pos = Position::startpos();
+        std::vector<uint64_t> h;
+        assert(pos.halfmove_clock() == 0);
+        play(pos, h, {"g1 f3", "g8 f6"});
+        assert(pos.halfmove_clock() == 2);
+        play(pos, h, {"e2 e4"});
+        assert(pos.halfmove_clock() == 0);
+        play(pos, h, {"f6 e4"});
+        assert(pos.halfmove_clock() == 0);
+
+        auto p = Parse::fen("8/8/8/4k3/8/8/8/R3K3 w - - 37 80");
+        assert(p && p->halfmove_clock() == 37);
+        auto q = Parse::fen("8/8/8/4k3/8/8/8/R3K3 w - -");
+        assert(q && q->halfmove_clock() == 0);
+    }
+
+    // Threefold: knights out and back twice
+    {
+        Position pos = Position::startpos();
+        std::vector<uint64_t> h;
+        play(pos, h, {"g1 f3", "g8 f6", "f3 g1", "f6 g8"});
+        assert(GameState::repetitions(pos, h) == 1);
+        assert(!GameState::is_threefold_repetition(pos, h));
+        play(pos, h, {"g1 f3", "g8 f6", "f3 g1", "f6 g8"});
+        assert(GameState::repetitions(pos, h) == 2);
+        assert(GameState::is_threefold_repetition(pos, h));
+    }
+
+    // A pawn move in between makes earlier positions unreachable
+    {
+        Position pos = Position::startpos();
+        std::vector<uint64_t> h;
+        play(pos, h, {"g1 f3", "g8 f6", "f3 g1", "f6 g8", "e2 e3", "e7 e6"});
+        play(pos, h, {"g1 f3", "g8 f6", "f3 g1", "f6 g8"});
+        assert(GameState::repetitions(pos, h) == 1);
+    }
+
+    // Fifty-move rule, unless the hundredth ply mates
+    {
+        auto draw = Parse::fen("8/8/8/4k3/8/8/8/R3K3 b - - 100 80");
+        assert(draw && GameState::is_fifty_move_draw(*draw));
+        auto early = Parse::fen("8/8/8/4k3/8/8/8/R3K3 b - - 99 80");
+        assert(early && !GameState::is_fifty_move_draw(*early));
+        auto mate = Parse::fen("R5k1/5ppp/8/8/8/8/8/6K1 b - - 100 80");
+        assert(mate && !GameState::is_fifty_move_draw(*mate));
+    }
+
+    std::cout << "test_draw: OK\n";
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "bench.hpp"
+#include "parse.hpp"
+#include "render.hpp"
+#include "support/testutil.hpp"
+
+using namespace chess;
+using test::MV;
+
+static FenError error_of(const char* fen) {
+    Position pos;
+    return Parse::fen(fen, pos).error;
+}
+
+int main() {
+    // Start position both ways
+    {
+        const char* start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+        auto pos = Parse::fen(start);
+        assert(pos && pos->key() == Position::startpos().key());
+        assert(Render::fen(Position::startpos()) == start);
+    }
+
+    // Every bench position reads back to the same string and key
+    for (const std::string& fen : Bench::positions()) {
+        auto pos = Parse::fen(fen);
+        assert(pos);
+        char buf[Render::FEN_MAX];
+        std::size_t n = Render::fen(*pos, buf);
+        assert(n == std::strlen(buf) && n < Render::FEN_MAX);
+        auto again = Parse::fen(std::string_view(buf, n));
+        assert(again && again->key() == pos->key());
+        assert(Render::fen(*again) == buf);
+    }
+
+    // Clocks: kept, advanced by moves, defaulted when missing
+    {
+        auto pos = Parse::fen("4k3/8/8/8/8/8/8/R3K3 b Q - 17 42");
+        assert(pos && pos->halfmove_clock() == 17 && pos->fullmove_number() == 42);
+        std::string err;
+        assert(pos->make_move(MV("e8", "d8"), err));
+        assert(Render::fen(*pos) == "3k4/8/8/8/8/8/8/R3K3 w Q - 18 43");
+
+        auto epd = Parse::fen("4k3/8/8/8/8/8/8/R3K3 w Q -");
+        assert(epd && epd->halfmove_clock() == 0 && epd->fullmove_number() == 1);
+        assert(Parse::fen("  4k3/8/8/8/8/8/8/4K3   w  -  -  3 9 \r\n"));
+    }
+
+    // En passant square after a double push, and its validation
+    {
+        Position pos = Position::startpos();
+        std::string err;
+        assert(pos.make_move(MV("e2", "e4"), err));
+        assert(Render::fen(pos) == "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1");
+        assert(error_of("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq d3 0 1") == FenError::EnPassant);
+        assert(error_of("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e3 0 1") == FenError::EnPassant);
+    }
+
+    // Structured errors, with the offset of the offending field
+    {
+        assert(error_of("") == FenError::MissingField);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3") == FenError::MissingField);
+        assert(error_of("4k3/8/8/8/8/8/8/4K2 w - -") == FenError::Board);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3/8 w - -") == FenError::Board);
+        assert(error_of("4k3/8/8/8/8/8/8/4X3 w - -") == FenError::Board);
+        assert(error_of("8/8/8/8/8/8/8/4K3 w - -") == FenError::Kings);
+        assert(error_of("4k3/8/8/8/8/8/8/3PK3 w - -") == FenError::PawnOnBackRank);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3 x - -") == FenError::SideToMove);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3 w K -") == FenError::Castling);
+        assert(error_of("4k3/8/8/8/8/8/8/R3K3 w QQ -") == FenError::Castling);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3 w - - x") == FenError::HalfmoveClock);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3 w - - 0 70000") == FenError::FullmoveNumber);
+        assert(error_of("4k3/8/8/8/8/8/8/4K3 w - - 0 1 junk") == FenError::TrailingInput);
+
+        Position pos;
+        FenStatus st = Parse::fen("4k3/8/8/8/8/8/8/4K3 w KQ -", pos);
+        assert(!st && st.offset == 22);
+        assert(std::string(Parse::fen_error(st.error)) == "bad castling rights");
+    }
+
+    // UCI moves read back to the same string
+    {
+        assert(Parse::uci_move("e2e4") == MV("e2", "e4"));
+        assert(Parse::uci_move("e7e8q") == MV("e7", "e8", 'q'));
+        assert(Parse::uci_move(" a2a1n ") == MV("a2", "a1", 'n'));
+        assert(!Parse::uci_move("e2e"));
+        assert(!Parse::uci_move("e2e4k"));
+        assert(!Parse::uci_move("i2e4"));
+
+        for (const char* s : {"e2e4", "e1g1", "b7b8r", "h2h1b"}) {
+            assert(Render::move_uci(*Parse::uci_move(s)) == s);
+        }
+    }
+
+    std::cout << "test_fen: OK\n";
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include <cassert>
+#include <iostream>
+
+#include "support/testutil.hpp"
+#include "movegen.hpp"
+#include "parse.hpp"
+#include "tt.hpp"
+
+using namespace chess;
+using namespace test;
+
+// Rebuild the position square by square; the key must not depend on history.
+static uint64_t fresh_key(const Position& pos) {
+    Position p;
+    for (int sq = 0; sq < 64; ++sq) p.set(sq, pos.at(sq));
+    p.set_side_to_move(pos.side_to_move());
+    p.set_castling_rights(pos.castling_rights());
+    p.set_ep_square(pos.ep_square());
+    return p.key();
+}
+
+// Walk the tree and compare incremental keys against fresh ones.
+static void walk(const Position& pos, int depth) {
+    assert(pos.key() == fresh_key(pos));
+    if (depth == 0) return;
+
+    MoveList moves;
+    MoveGen::generate_legal(pos, moves);
+    for (int i = 0; i < moves.size; ++i) {
+        Position child = pos;
+        std::string err;
+        bool ok = child.make_move(moves.moves[i], err);
+        assert(ok);
+        walk(child, depth - 1);
+    }
+}
+
+int main() {
+    // 1) Empty position hashes to zero
+    {
+        Position pos;
+        assert(pos.key() == 0);
+    }
+
+    // 2) Incremental keys match through castling, ep and promotions
+    {
+        walk(Position::startpos(), 3);
+
+        auto kiwipete = Parse::fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        assert(kiwipete);
+        walk(*kiwipete, 2);
+
+        auto promo = Parse::fen("8/P6k/8/8/8/8/6Kp/8 w - - 0 1");
+        assert(promo);
+        walk(*promo, 3);
+    }
+
+    // 3) Transpositions reach the same key
+    {
+        Position a = Position::startpos();
+        Position b = Position::startpos();
+        std::string err;
+        a.make_move(MV("g1", "f3"), err); a.make_move(MV("g8", "f6"), err);
+        a.make_move(MV("b1", "c3"), err); a.make_move(MV("b8", "c6"), err);
+        b.make_move(MV("b1", "c3"), err); b.make_move(MV("b8", "c6"), err);
+        b.make_move(MV("g1", "f3"), err); b.make_move(MV("g8", "f6"), err);
+        assert(a.key() == b.key());
+    }
+
+    // 4) Side to move and ep square are part of the key
+    {
+        Position a = Position::startpos();
+        Position b = a;
+        b.make_null_move();
+        assert(a.key() != b.key());
+
+        std::string err;
+        Position c = Position::startpos();
+        c.make_move(MV("e2", "e4"), err);
+        Position d = c;
+        d.set_ep_square(-1);
+        assert(c.key() != d.key());
+    }
+
+    // 5) Transposition table: entries read back whole, and another key in
+    //    the same slot is a miss
+    {
+        TranspositionTable tt(1);
+        const uint64_t key = Position::startpos().key();
+        const uint64_t other_key = key ^ (1ULL << 63);   // same slot
+        TTEntry e;
+        assert(!tt.probe(key, e));
+
+        tt.store(key, MV("e2", "e4"), -99990, 6, BOUND_EXACT);
+        assert(tt.probe(key, e));
+        assert(e.move == MV("e2", "e4") && e.score == -99990 && e.depth == 6 && e.bound == BOUND_EXACT);
+        assert(!tt.probe(other_key, e));
+
+        // A fail-low store without a move keeps the move already known
+        tt.store(key, Move{}, -20, 7, BOUND_UPPER);
+        assert(tt.probe(key, e) && e.move == MV("e2", "e4") && e.bound == BOUND_UPPER);
+
+        // Within a search a deeper entry survives a shallower one...
+        tt.store(other_key, MV("d2", "d4"), 0, 2, BOUND_LOWER);
+        assert(tt.probe(key, e) && !tt.probe(other_key, e));
+
+        // ...but entries from an earlier search are always replaced
+        tt.new_search();
+        tt.store(other_key, MV("d2", "d4"), 0, 2, BOUND_LOWER);
+        assert(!tt.probe(key, e) && tt.probe(other_key, e) && e.move == MV("d2", "d4"));
+
+        tt.clear();
+        assert(!tt.probe(other_key, e) && tt.hashfull() == 0);
+    }
+
+    std::cout << "test_hash: OK\n";
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "match.hpp"
+#include "parse.hpp"
+#include "pgn.hpp"
+
+using namespace chess;
+
+static Opening opening(const char* fen4) {
+    Opening o;
+    o.start = *Parse::fen(fen4);
+    o.fen = std::string(fen4) + " 0 1";
+    return o;
+}
+
+int main() {
+    // SPRT: an even score rejects a +5 Elo improvement, a big plus accepts it
+    {
+        SprtConfig cfg;
+        cfg.enabled = true;
+        MatchScore even{5000, 10000, 5000};
+        assert(Sprt::llr(even, 0, 5) < 0);
+        assert(Sprt::verdict(even, cfg) == SprtVerdict::AcceptH0);
+
+        MatchScore strong{300, 100, 100};
+        assert(Sprt::verdict(strong, cfg) == SprtVerdict::AcceptH1);
+        assert(std::abs(strong.elo() - 147.2) < 1.0);
+        assert(strong.elo_error() > 0);
+
+        MatchScore few{3, 1, 2};
+        assert(Sprt::verdict(few, cfg) == SprtVerdict::None);
+        assert(std::abs(Sprt::upper_bound(0.05, 0.05) - 2.944) < 0.01);
+        assert(std::abs(Sprt::lower_bound(0.05, 0.05) + 2.944) < 0.01);
+    }
+
+    MatchOptions opts;
+    opts.tc.depth = 3;
+
+    // Mate in one for White ends the game 1-0 on the board
+    {
+        GameRecord r = Match::play_game(opts.a, opts.b, opening("6k1/5ppp/8/8/8/8/8/R5K1 w - -"), opts);
+        assert(r.result == 1);
+        assert(r.termination == "checkmate");
+        assert(r.pgn.moves.size() == 1);
+        assert(r.pgn.result == "1-0");
+    }
+
+    // Bare kings are drawn before any move is made
+    {
+        GameRecord r = Match::play_game(opts.a, opts.b, opening("8/8/4k3/8/8/4K3/8/8 w - -"), opts);
+        assert(r.result == 0 && r.termination == "insufficient material");
+        assert(r.pgn.moves.empty());
+    }
+
+    // Threefold repetition inside the opening moves ends the game at once
+    {
+        Opening o;
+        o.start = Position::startpos();
+        for (const char* m : {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3", "g8f6", "f3g1", "f6g8"})
+            o.moves.push_back(*Parse::uci_move(m));
+        GameRecord r = Match::play_game(opts.a, opts.b, o, opts);
+        assert(r.result == 0 && r.termination == "repetition");
+        assert(r.pgn.moves.size() == 8);
+    }
+
+    // So does a start position already at the fifty-move limit
+    {
+        Opening o;
+        o.start = *Parse::fen("8/8/4k3/8/8/3RK3/8/8 w - - 100 80");
+        GameRecord r = Match::play_game(opts.a, opts.b, o, opts);
+        assert(r.result == 0 && r.termination == "fifty moves");
+        assert(r.pgn.moves.empty());
+    }
+
+    // A short node-limited match; games are written as PGN that reads back
+    {
+        const char* openings = "match_openings.epd";
+        const char* pgn = "match_games.pgn";
+        std::remove(pgn);
+        {
+            std::ofstream f(openings);
+            f << "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq -\n"
+                 "rnbqkbnr/pppppppp/8/8/3P4/8/PPP1PPPP/RNBQKBNR b KQkq -\n";
+        }
+
+        MatchOptions m;
+        m.tc = TimeControl{};
+        m.tc.nodes = 500;
+        m.games = 4;
+        m.concurrency = 2;
+        m.max_plies = 40;
+        m.openings = openings;
+        m.pgn_path = pgn;
+
+        int reports = 0;
+        Match match(m);
+        std::string err;
+        bool ok = match.run(err, [&](const MatchScore&, double, const GameRecord&) { ++reports; });
+        assert(ok);
+        assert(reports == 4);
+        assert(match.score().games() == 4);
+
+        std::ifstream in(pgn);
+        std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        auto games = Pgn::split_games(text);
+        assert(games.size() == 4);
+        for (auto g : games) {
+            PgnGame game;
+            assert(Pgn::parse_game(g, game, err));
+            assert(game.result != "*");
+            assert(!game.tag("Termination").empty());
+            assert(game.start.side_to_move() == Color::Black);
+        }
+        std::remove(openings);
+        std::remove(pgn);
+    }
+
+    std::cout << "test_match passed\n";
+    return 0;
+}
@@ -74,6 +74,23 @@ int main() {
 #endif
     }
 
+    // -------------------------
+    // INSUFFICIENT MATERIAL: neither side can ever mate
+    //
+    // K+N v K and same-coloured bishops are dead draws; bishops on
+    // opposite colours or a rook are not.
+    // -------------------------
+    {
+        EXPECT(GameState::is_insufficient_material(*Parse::fen("8/8/4k3/8/8/3NK3/8/8 w - -")),
+               "Expected K+N v K to be insufficient.");
+        EXPECT(GameState::is_insufficient_material(*Parse::fen("8/8/2b1k3/8/8/3BK3/8/8 w - -")),
+               "Expected same-coloured bishops to be insufficient.");
+        EXPECT(!GameState::is_insufficient_material(*Parse::fen("8/8/3bk3/8/8/3BK3/8/8 w - -")),
+               "Expected opposite-coloured bishops to be sufficient.");
+        EXPECT(!GameState::is_insufficient_material(*Parse::fen("8/8/4k3/8/8/3RK3/8/8 w - -")),
+               "Expected K+R v K to be sufficient.");
+    }
+
     std::cout << "test_mate_stalemate: OK (if stm supported)\n";
     return 0;
 }
@@ -0,0 +1,204 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <iostream>
+
+#include "support/testutil.hpp"
+#include "book.hpp"
+#include "book_builder.hpp"
+#include "parse.hpp"
+#include "pgn.hpp"
+#include "render.hpp"
+#include "movegen.hpp"
+
+using namespace chess;
+using namespace test;
+
+static const char* PGN =
+    "[Event \"Game one\"]\n"
+    "[White \"A\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 e5 2. Nf3 {main line} Nc6 (2... d6 3. d4) 3. Bb5 $1 a6 4. Ba4 Nf6\n"
+    "5. O-O Be7 1-0\n"
+    "\n"
+    "[Event \"Game two\"]\n"
+    "[Result \"1/2-1/2\"]\n"
+    "\n"
+    "1.e4 c5 2.Nf3 d6; a comment to end of line\n"
+    "3.d4 cxd4 4.Nxd4 Nf6 5.Nc3 a6 1/2-1/2\n"
+    "\n"
+    "[Event \"Game three\"]\n"
+    "[Result \"0-1\"]\n"
+    "\n"
+    "1. d4 d5 2. c4 e6 3. Nc3 Nf6 4. Bg5 Be7 0-1\n"
+    "\n"
+    "[Event \"Broken\"]\n"
+    "[Result \"*\"]\n"
+    "\n"
+    "1. e4 e4 *\n";
+
+int main() {
+    Position start = Position::startpos();
+
+    // 1) SAN: pieces, captures, disambiguation, castling, promotion, checks
+    {
+        assert(Parse::san(start, "e4") == MV("e2", "e4"));
+        assert(Parse::san(start, "Nf3") == MV("g1", "f3"));
+        assert(!Parse::san(start, "e5"));
+        assert(!Parse::san(start, "Nd2"));   // own pawn there
+
+        auto rooks = Parse::fen("4k3/8/8/8/8/8/8/R3K2R w K - 0 1");
+        assert(rooks);
+        assert(Parse::san(*rooks, "Rd1") == MV("a1", "d1"));   // king blocks h1
+
+        auto open_rooks = Parse::fen("4k3/8/8/8/8/8/4K3/R6R w - - 0 1");
+        assert(open_rooks);
+        assert(!Parse::san(*open_rooks, "Rd1"));   // ambiguous
+        assert(Parse::san(*open_rooks, "Rhd1") == MV("h1", "d1"));
+        assert(Parse::san(*rooks, "Rad1") == MV("a1", "d1"));
+        assert(Parse::san(*rooks, "Rhf1") == MV("h1", "f1"));
+        assert(Parse::san(*rooks, "O-O") == MV("e1", "g1"));
+        assert(!Parse::san(*rooks, "O-O-O"));   // no queen-side right
+
+        auto promo = Parse::fen("1r2k3/P7/8/8/8/8/8/4K3 w - - 0 1");
+        assert(promo);
+        assert(Parse::san(*promo, "a8=Q+") == MV("a7", "a8", 'q'));
+        assert(Parse::san(*promo, "axb8=N") == MV("a7", "b8", 'n'));
+        assert(Parse::san(*promo, "axb8R") == MV("a7", "b8", 'r'));
+
+        auto ep = Parse::fen("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+        assert(ep);
+        assert(Parse::san(*ep, "exd6") == MV("e5", "d6"));
+    }
+
+    // 2) Rendered SAN reads back as the same move, two plies deep
+    {
+        auto kiwi = Parse::fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        assert(kiwi);
+        MoveList root;
+        MoveGen::generate_legal(*kiwi, root);
+        for (int i = 0; i < root.size; ++i) {
+            const Move& m = root.moves[i];
+            assert(Parse::san(*kiwi, Render::move_san(*kiwi, m)) == m);
+
+            Position child = *kiwi;
+            std::string err;
+            child.make_move(m, err);
+            MoveList replies;
+            MoveGen::generate_legal(child, replies);
+            for (int j = 0; j < replies.size; ++j)
+                assert(Parse::san(child, Render::move_san(child, replies.moves[j])) == replies.moves[j]);
+        }
+        assert(Render::move_san(*kiwi, MV("e1", "g1")) == "O-O");
+        assert(Render::move_san(*kiwi, MV("e5", "f7")) == "Nxf7");
+        assert(Render::move_san(*kiwi, MV("d5", "e6")) == "dxe6");
+
+        auto mate = Parse::fen("k7/8/1K6/8/8/8/8/6Q1 w - - 0 1");
+        assert(Render::move_san(*mate, MV("g1", "g8")) == "Qg8#");
+        assert(Render::move_san(*mate, MV("g1", "g2")) == "Qg2+");
+
+        auto rooks = Parse::fen("4k3/8/8/8/8/8/4K3/R6R w - - 0 1");
+        assert(Render::move_san(*rooks, MV("a1", "d1")) == "Rad1");
+    }
+
+    // 3) PGN: split into games, skip comments/variations/NAGs, keep tags
+    std::vector<std::string_view> games = Pgn::split_games(PGN);
+    assert(games.size() == 4);
+    {
+        PgnGame g;
+        std::string err;
+        assert(Pgn::parse_game(games[0], g, err));
+        assert(g.tag("Event") == "Game one");
+        assert(g.result == "1-0");
+        assert(g.moves.size() == 10);
+        assert(g.moves[8] == MV("e1", "g1"));
+
+        assert(Pgn::parse_game(games[1], g, err));
+        assert(g.moves.size() == 10 && g.result == "1/2-1/2");
+
+        // Truncated parse still knows the result
+        assert(Pgn::parse_game(games[2], g, err, 3));
+        assert(g.moves.size() == 3 && g.result == "0-1");
+
+        assert(!Pgn::parse_game(games[3], g, err));
+        assert(!err.empty());
+
+        // FEN tag sets the start position
+        assert(Pgn::parse_game("[FEN \"4k3/8/8/8/8/8/8/R3K2R w K - 0 1\"]\n\n1. O-O Kd7 *", g, err));
+        assert(g.moves.size() == 2 && g.moves[0] == MV("e1", "g1"));
+
+        std::string_view text(PGN);
+        std::size_t second = Pgn::next_game_start(text, 1);
+        assert(text.substr(second, 17) == "[Event \"Game two\"");
+    }
+
+    // 4) Builder: parallel parse, counts per (position, move), sorted output
+    {
+        std::string all;
+        for (int i = 0; i < 50; ++i) all += PGN;
+
+        BookBuildOptions opts;
+        opts.threads = 4;
+        opts.max_ply = 6;
+        BookBuilder builder(opts);
+        builder.add_pgn_text(all);
+
+        BookBuildStats s = builder.stats();
+        assert(s.games == 150 && s.bad_games == 50);
+
+        std::string path = "test_pgn_book.bin", err;
+        bool ok = builder.write(path, err);
+        if (!ok) std::cerr << err << "\n";
+        assert(ok);
+
+        Book book;
+        assert(book.open(path, err));
+        assert(book.size() == builder.stats().entries);
+
+        auto es = book.entries(start);
+        assert(es.size() == 2);
+        assert(es[0].move == MV("e2", "e4") && es[0].weight == 100);
+        assert(es[1].move == MV("d2", "d4") && es[1].weight == 50);
+
+        Position after = start;
+        after.make_move(MV("e2", "e4"), err);
+        auto replies = book.entries(after);
+        assert(replies.size() == 2);   // e5 and c5, 50 each; variations ignored
+
+        // Past max_ply nothing is recorded
+        Position deep = start;
+        for (const char* m : {"e4", "e5", "Nf3", "Nc6", "Bb5", "a6"}) {
+            auto mv = Parse::san(deep, m);
+            assert(mv);
+            deep.make_move(*mv, err);
+        }
+        assert(book.entries(deep).empty());
+
+        // The raw records carry the reference Polyglot keys, so other tools
+        // read the book: start position with e2e4 (0x031c), and the position
+        // after 1.e4 with e7e5 (0x0d24)
+        {
+            std::ifstream in(path, std::ios::binary);
+            std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            auto be = [&](std::size_t at, int n) {
+                uint64_t v = 0;
+                for (int i = 0; i < n; ++i) v = (v << 8) | (unsigned char)bytes[at + i];
+                return v;
+            };
+            bool start_e4 = false, after_e4_e5 = false;
+            for (std::size_t at = 0; at + Book::ENTRY_SIZE <= bytes.size(); at += Book::ENTRY_SIZE) {
+                if (be(at, 8) == 0x463b96181691fc9cULL && be(at + 8, 2) == 0x031c) start_e4 = be(at + 10, 2) == 100;
+                if (be(at, 8) == 0x823c9b50fd114196ULL && be(at + 8, 2) == 0x0d24) after_e4_e5 = true;
+            }
+            assert(start_e4 && after_e4_e5);
+        }
+
+        book.close();
+        std::remove(path.c_str());
+    }
+
+    std::cout << "test_pgn: OK\n";
+    return 0;
+}
@@ -0,0 +1,319 @@
+#include <cassert>
+#include <iostream>
+
+#include "support/testutil.hpp"
+#include "search.hpp"
+#include "engine.hpp"
+#include "movegen.hpp"
+
+using namespace chess;
+using namespace test;
+
+// Replays a PV from `pos`; every move must be legal in sequence.
+static bool pv_is_legal(Position pos, const std::vector<Move>& pv) {
+    for (const Move& m : pv) {
+        std::string err;
+        if (!pos.make_move(m, err)) {
+            std::cerr << "PV move rejected: " << err << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    // 1) Mate in one: Qb7 after Kc6, Black king on a8 (back-rank style)
+    {
+        auto pos = PosBuilder()
+            .stm(Color::White)
+            .piece("a8", Piece::BK)
+            .piece("c6", Piece::WK)
+            .piece("b1", Piece::WQ)
+            .build();
+
+        SearchResult res = Search::minimax(pos, 3);
+        assert(res.best == MV("b1", "b7"));
+        assert(res.score > 90000);
+        assert(!res.pv.empty() && res.pv.front() == res.best);
+        assert(pv_is_legal(pos, res.pv));
+    }
+
+    // 2) Same pattern with colors swapped: score is reported from White's view
+    {
+        auto pos = PosBuilder()
+            .stm(Color::Black)
+            .piece("a1", Piece::WK)
+            .piece("c3", Piece::BK)
+            .piece("b8", Piece::BQ)
+            .build();
+
+        SearchResult res = Search::minimax(pos, 3);
+        assert(res.best == MV("b8", "b2"));
+        assert(res.score < -90000);
+    }
+
+    // 3) Start position: full-depth PV is a legal line of the searched length
+    {
+        Position pos = Position::startpos();
+        SearchResult res = Search::minimax(pos, 4);
+        assert(res.depth == 4);
+        assert((int)res.pv.size() == 4);
+        assert(pv_is_legal(pos, res.pv));
+    }
+
+    // 4) Free queen: winning material survives the aspiration re-searches
+    {
+        auto pos = PosBuilder()
+            .stm(Color::White)
+            .piece("e1", Piece::WK)
+            .piece("d1", Piece::WR)
+            .piece("d5", Piece::BQ)
+            .piece("h8", Piece::BK)
+            .build();
+
+        SearchResult res = Search::minimax(pos, 4);
+        assert(res.best == MV("d1", "d5"));
+        assert(res.score >= 400);
+    }
+
+    // 5) Null move in a pawn ending: White to move wins only by playing d7
+    //    (Black to move would hold the draw), so a pass must never be tried
+    {
+        auto pos = PosBuilder()
+            .stm(Color::White)
+            .piece("d8", Piece::BK)
+            .piece("e6", Piece::WK)
+            .piece("d6", Piece::WP)
+            .build();
+
+        SearchResult res = Search::minimax(pos, 12);
+        assert(res.best == MV("d6", "d7"));
+        assert(res.score >= 800);
+    }
+
+    // 6) Null move and LMR only prune: turned off, a small tactical set finds
+    //    the same moves at the same depth, with more nodes
+    {
+        struct Tactic { Position pos; Move best; };
+        const Tactic tactics[] = {
+            {PosBuilder().stm(Color::White)
+                 .piece("g1", Piece::WK).piece("a1", Piece::WR)
+                 .piece("g8", Piece::BK).piece("f7", Piece::BP).piece("g7", Piece::BP).piece("h7", Piece::BP)
+                 .build(), MV("a1", "a8")},
+            {PosBuilder().stm(Color::White)
+                 .piece("e1", Piece::WK).piece("d5", Piece::WN)
+                 .piece("e8", Piece::BK).piece("a8", Piece::BR)
+                 .build(), MV("d5", "c7")},
+            {PosBuilder().stm(Color::White)
+                 .piece("g1", Piece::WK).piece("d1", Piece::WR).piece("c3", Piece::WN)
+                 .piece("a2", Piece::WP).piece("b2", Piece::WP).piece("f2", Piece::WP)
+                 .piece("g2", Piece::WP).piece("h2", Piece::WP)
+                 .piece("g8", Piece::BK)
+                 .piece("a7", Piece::BP).piece("b7", Piece::BP).piece("f7", Piece::BP)
+                 .piece("g7", Piece::BP).piece("h7", Piece::BP)
+                 .build(), MV("d1", "d8")},
+            {PosBuilder().stm(Color::Black)
+                 .piece("g1", Piece::WK).piece("a3", Piece::WR).piece("c3", Piece::WN)
+                 .piece("f2", Piece::WP).piece("g2", Piece::WP).piece("h2", Piece::WP)
+                 .piece("g8", Piece::BK).piece("e5", Piece::BQ)
+                 .piece("f7", Piece::BP).piece("g7", Piece::BP).piece("h7", Piece::BP)
+                 .build(), MV("e5", "e1")},
+        };
+        SearchParams off;
+        off.null_min_depth = off.lmr_min_depth = 1000;   // never reached
+
+        uint64_t pruned_nodes = 0, plain_nodes = 0;
+        for (const Tactic& t : tactics) {
+            Position pos = t.pos;
+            SearchResult a = Search::minimax(pos, 5);
+            SearchResult b = Search::minimax(pos, 5, off);
+            assert(a.best == t.best);
+            assert(b.best == a.best);
+            pruned_nodes += a.nodes;
+            plain_nodes += b.nodes;
+        }
+        assert(pruned_nodes < plain_nodes);
+    }
+
+    // 7) Node limit stops the search and still returns a legal move
+    {
+        TranspositionTable tt(1);
+        Searcher searcher(tt);
+        SearchLimits limits;
+        limits.nodes = 2000;
+
+        Position pos = Position::startpos();
+        SearchResult res = searcher.search(pos, limits);
+        assert(res.depth >= 1);
+        assert(res.nodes < 20000);
+        assert(pv_is_legal(pos, {res.best}));
+    }
+
+    // 8) Multi-threaded engine agrees on a forced mate
+    {
+        auto pos = PosBuilder()
+            .stm(Color::White)
+            .piece("a8", Piece::BK)
+            .piece("c6", Piece::WK)
+            .piece("b1", Piece::WQ)
+            .build();
+
+        Engine engine;
+        engine.set_threads(3);
+        SearchLimits limits;
+        limits.depth = 4;
+        SearchResult res = engine.search(pos, limits);
+        assert(res.best == MV("b1", "b7"));
+    }
+
+    // 9) Ponder: the result is held until ponderhit, then the search finishes
+    //    under its real limits; a miss is just a stop
+    {
+        auto pos = PosBuilder()
+            .stm(Color::White)
+            .piece("a8", Piece::BK)
+            .piece("c6", Piece::WK)
+            .piece("b1", Piece::WQ)
+            .build();
+
+        Engine engine;
+        SearchLimits limits;
+        limits.movetime_ms = 50;
+        limits.ponder = true;
+
+        bool done = false;
+        SearchResult res;
+        engine.go(pos, limits, {}, [&](const SearchResult& r) { res = r; done = true; });
+        assert(engine.pondering());
+        engine.ponderhit();
+        engine.wait();
+        assert(done && res.best == MV("b1", "b7"));
+
+        done = false;
+        engine.go(Position::startpos(), limits, {}, [&](const SearchResult&) { done = true; });
+        engine.stop();
+        engine.wait();
+        assert(done && !engine.searching());
+    }
+
+    // En passant is a capture: quiescence after ...d5 must see exd6
+    {
+        TranspositionTable tt(16);
+        Searcher s(tt);
+        SearchLimits limits;
+        limits.depth = 1;
+        limits.multipv = 16;
+        auto pos = Parse::fen("4k3/3p4/8/4P3/8/8/8/4K3 b - - 0 1");
+        assert(pos);
+        SearchResult res = s.search(*pos, limits);
+        bool seen = false;
+        for (const PvLine& line : res.lines) {
+            if (!(line.pv[0] == MV("d7", "d5"))) continue;
+            seen = true;
+            assert(line.score >= 50);   // White's view: a pawn up
+        }
+        assert(seen);
+    }
+
+    // minimax with the caller's table: a repeated search starts warm
+    {
+        TranspositionTable tt(16);
+        Position a = Position::startpos(), b = Position::startpos();
+        SearchResult cold = Search::minimax(a, 5, SearchParams{}, tt);
+        SearchResult warm = Search::minimax(b, 5, SearchParams{}, tt);
+        assert(warm.best == cold.best);
+        assert(warm.nodes < cold.nodes);
+
+        // The built-in table is cleared per call: repeated calls match
+        Position c = Position::startpos(), d = Position::startpos();
+        assert(Search::minimax(c, 5).nodes == Search::minimax(d, 5).nodes);
+    }
+
+    // Statistics: one entry per iteration, counters consistent with nodes
+    {
+        TranspositionTable tt(16);
+        Searcher s(tt);
+        SearchLimits limits;
+        limits.depth = 5;
+        SearchResult res = s.search(Position::startpos(), limits);
+        const SearchStats& st = res.stats;
+        if constexpr (SearchStats::enabled) {
+            assert((int)st.iterations.size() == 5);
+            uint64_t sum = 0;
+            for (const auto& it : st.iterations) sum += it.nodes;
+            assert(sum == st.nodes && st.nodes == res.nodes);
+            assert(st.qnodes > 0 && st.qnodes < st.nodes);
+            assert(st.beta_cutoffs > 0 && st.first_move_cutoffs <= st.beta_cutoffs);
+            assert(st.tt_hits <= st.tt_probes && st.tt_cutoffs <= st.tt_hits);
+            assert(st.seldepth >= 5);
+            assert(st.branching_factor() > 1.0);
+        } else {
+            assert(st.iterations.empty() && st.nodes == 0);
+        }
+    }
+
+    // Fifty-move rule: no mate in one with the clock at 99, so every line
+    // ends in a draw
+    {
+        TranspositionTable tt(16);
+        Searcher s(tt);
+        SearchLimits limits;
+        limits.depth = 4;
+        auto pos = Parse::fen("8/8/8/4k3/8/8/8/R3K3 w - - 99 80");
+        assert(pos);
+        assert(s.search(*pos, limits).score == 0);
+    }
+
+    // Perpetual check: a queen and rook down, Qh5+/Qe8+ holds the draw
+    {
+        TranspositionTable tt(16);
+        Searcher s(tt);
+        SearchLimits limits;
+        limits.depth = 8;
+        auto pos = Parse::fen("8/6pk/8/8/8/8/qr6/3Q3K w - - 0 1");
+        assert(pos);
+        SearchResult res = s.search(*pos, limits);
+        assert(res.score == 0);
+        assert(res.best == MV("d1", "h5"));
+    }
+
+    // MultiPV: distinct root moves, ranked, the first one the main line
+    {
+        TranspositionTable tt(16);
+        Searcher s(tt);
+        SearchLimits limits;
+        limits.depth = 4;
+        limits.multipv = 3;
+        int infos = 0;
+        SearchResult res = s.search(Position::startpos(), limits, [&](const SearchInfo& info) {
+            if (!info.pv.empty()) assert(info.multipv >= 1 && info.multipv <= 3), ++infos;
+        });
+        assert(res.lines.size() == 3 && infos == 3 * 4);
+        assert(res.lines[0].pv == res.pv && res.lines[0].score == res.score);
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < i; ++j) assert(!(res.lines[i].pv[0] == res.lines[j].pv[0]));
+            if (i > 0) assert(res.lines[i - 1].score >= res.lines[i].score);
+        }
+
+        // Two moves win the queen (Rxd5, Re2+); every other move is far behind
+        auto pos = Parse::fen("4k3/8/8/3q4/8/8/3R4/3RK3 w - - 0 1");
+        assert(pos);
+        limits.depth = 3;
+        res = s.search(*pos, limits);
+        assert(res.lines.size() == 3);
+        assert(res.lines[0].score == res.lines[1].score);
+        assert(res.lines[1].score > res.lines[2].score + 500);
+
+        // Never more lines than legal moves
+        auto two = Parse::fen("k7/8/1K6/8/8/8/8/7R b - - 0 1");
+        assert(two);
+        limits.multipv = 10;
+        res = s.search(*two, limits);
+        MoveList legal;
+        MoveGen::generate_legal(*two, legal);
+        assert((int)res.lines.size() == legal.size);
+    }
+
+    std::cout << "test_search: OK\n";
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <cassert>
+#include <iostream>
+
+#include "parse.hpp"
+#include "rules.hpp"
+#include "see.hpp"
+#include "support/testutil.hpp"
+
+using namespace chess;
+using test::MV;
+using test::SQ;
+
+static int see(const char* fen, const char* from, const char* to, uint8_t promo = PROMO_NONE) {
+    auto pos = Parse::fen(fen);
+    assert(pos);
+    Move m = MV(from, to);
+    m.promo = promo;
+    return See::value(*pos, m);
+}
+
+int main() {
+    // Undefended pawn
+    assert(see("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - -", "e1", "e5") == 100);
+
+    // Long exchange with x-rays on both sides: N, R and Q behind each other
+    // for White, N, B and Q for Black. Winning a pawn costs the knight.
+    assert(see("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - -", "d3", "e5") == 100 - 320);
+
+    // Queen takes a pawn defended by a pawn
+    assert(see("4k3/8/3p4/4p3/8/8/8/4QK2 w - -", "e1", "e5") == 100 - 900);
+
+    // Doubled rooks win a pawn defended by one rook, but not by two
+    assert(see("3rk3/8/8/3p4/8/8/3R4/3RK3 w - -", "d2", "d5") == 100);
+    assert(see("3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - -", "d2", "d5") == 100 - 500);
+
+    // The king only recaptures on an undefended square
+    assert(see("8/8/8/3pk3/8/8/3R4/4K3 w - -", "d2", "d5") == 100 - 500);
+    assert(see("8/8/8/3pk3/8/8/3R4/3RK3 w - -", "d2", "d5") == 100);
+
+    // En passant and promotion
+    assert(see("4k3/8/8/3pP3/8/8/8/4K3 w - d6", "e5", "d6") == 100);
+    assert(see("4k3/P7/8/8/8/8/8/4K3 w - -", "a7", "a8", PROMO_Q) == 800);
+    assert(see("1r2k3/P7/8/8/8/8/8/4K3 w - -", "a7", "a8", PROMO_Q) == 800 - 900);
+
+    // A pawn recapturing on the last rank comes back as a queen, so after
+    // Rxb8 Black can't afford Nxb8 (axb8=Q); as a pawn it would be worth it
+    assert(see("1r2k3/P2n4/8/8/8/8/8/1R2K3 w - -", "b1", "b8") == 500);
+
+    // Quiet move onto an attacked square loses the piece
+    assert(see("4k3/8/3p4/8/8/8/8/2B1K3 w - -", "c1", "e3") == 0);
+    assert(see("4k3/8/5p2/8/8/8/8/2B1K3 w - -", "c1", "g5") == -330);
+
+    // Cheapest attacker first
+    {
+        auto pos = Parse::fen("4k3/8/8/3p4/2P1N3/8/3Q4/4K3 w - -");
+        assert(Rules::smallest_attacker(*pos, SQ("d5"), Color::White) == SQ("c4"));
+        assert(Rules::smallest_attacker(*pos, SQ("d4"), Color::Black) == -1);
+    }
+
+    std::cout << "test_see: OK\n";
+    return 0;
+}
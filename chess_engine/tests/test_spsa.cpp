@@ -0,0 +1,76 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include "spsa.hpp"
+
+using namespace chess;
+
+int main() {
+    SpsaOptions opts;
+    opts.iterations = 100;
+
+    // Schedules end at c_end and r_end * c_end^2, and shrink over time
+    {
+        Spsa spsa(opts, Spsa::default_params());
+        const SpsaParam& p = spsa.params()[3];
+        assert(p.name == "rfp_margin");
+        assert(std::abs(spsa.c_k(3, 99) - p.c_end) < 1e-9);
+        assert(std::abs(spsa.a_k(3, 99) - p.r_end * p.c_end * p.c_end) < 1e-9);
+        assert(spsa.c_k(3, 0) > spsa.c_k(3, 50) && spsa.a_k(3, 0) > spsa.a_k(3, 50));
+    }
+
+    // An update moves each parameter along its sign and stays in range
+    {
+        std::vector<SpsaParam> ps = {{"rfp_margin", 90, 30, 250, 10, 0.002},
+                                     {"razor_margin", 699.9, 100, 700, 30, 0.002}};
+        Spsa spsa(opts, ps);
+        spsa.update(0, {+1, +1}, 2.0);
+        assert(spsa.params()[0].value > 90);
+        assert(spsa.params()[1].value == 700);
+        spsa.update(1, {-1, +1}, 2.0);
+        assert(spsa.params()[1].value == 700);
+        assert(spsa.current().razor_margin == 700);
+    }
+
+    // Short run with checkpoints, then a resume that finishes the rest
+    {
+        const std::string path = "test_spsa_tmp.txt";
+        std::remove(path.c_str());
+
+        opts.iterations = 2;
+        opts.checkpoint = path;
+        opts.checkpoint_every = 1;
+        opts.seed = 3;
+        opts.match.tc.depth = 1;
+        opts.match.max_plies = 16;
+        opts.match.concurrency = 2;
+        opts.match.a.hash_mb = 1;
+
+        std::vector<SpsaParam> ps = {{"rfp_margin", 90, 30, 250, 10, 0.002}};
+        std::string err;
+        {
+            Spsa spsa(opts, ps);
+            int reports = 0;
+            assert(spsa.run(err, [&](int, const std::vector<SpsaParam>&) { ++reports; }));
+            assert(spsa.iteration() == 2 && reports == 2);
+        }
+        {
+            opts.iterations = 4;
+            Spsa spsa(opts, {});
+            assert(spsa.run(err));
+            assert(spsa.iteration() == 4);
+            assert(spsa.params().size() == 1 && spsa.params()[0].name == "rfp_margin");
+        }
+        {
+            Spsa spsa(opts, {});
+            assert(spsa.load(path, err) && spsa.iteration() == 4);
+        }
+        std::remove(path.c_str());
+    }
+
+    std::cout << "test_spsa: OK\n";
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <cassert>
+#include <iostream>
+
+#include "support/testutil.hpp"
+#include "engine.hpp"
+#include "parse.hpp"
+#include "tablebase.hpp"
+
+using namespace chess;
+using namespace test;
+
+static TbResult probe(const Tablebase& tb, const std::string& fen) {
+    auto pos = Parse::fen(fen);
+    assert(pos);
+    auto r = tb.probe(*pos);
+    assert(r);
+    return *r;
+}
+
+int main() {
+    // 1) Names: stronger side first, whatever the colours
+    {
+        auto pos = Parse::fen("8/8/8/8/8/8/8/k1K4r w - - 0 1");
+        assert(Tablebase::material_name(*pos) == "KRvK");
+        assert(Tablebase::all_names(3).size() == 3);   // KQvK KRvK KPvK
+    }
+
+    Tablebase tb;
+    std::string err;
+    bool ok = tb.generate("KPvK", err);   // also builds KQvK and KRvK
+    if (!ok) std::cerr << err << "\n";
+    assert(ok);
+    assert(tb.has("KQvK") && tb.has("KRvK") && tb.has("KPvK"));
+
+    // 2) Known results
+    {
+        TbResult r = probe(tb, "k7/8/1K6/8/8/8/8/6Q1 w - - 0 1");      // Qg8#
+        assert(r.wdl == Wdl::Win && r.dtm == 1);
+
+        r = probe(tb, "k7/1Q6/1K6/8/8/8/8/8 b - - 0 1");               // mated
+        assert(r.wdl == Wdl::Loss && r.dtm == 0);
+
+        r = probe(tb, "k7/2Q5/1K6/8/8/8/8/8 b - - 0 1");              // stalemate
+        assert(r.wdl == Wdl::Draw);
+
+        r = probe(tb, "8/8/8/8/8/4k3/4P3/4K3 w - - 0 1");             // opposition
+        assert(r.wdl == Wdl::Draw);
+
+        r = probe(tb, "4k3/8/4K3/4P3/8/8/8/8 w - - 0 1");             // king in front
+        assert(r.wdl == Wdl::Win);
+
+        r = probe(tb, "8/8/8/8/8/4k3/8/4K2r w - - 0 1");              // colours reversed
+        assert(r.wdl == Wdl::Loss);
+    }
+
+    // 3) Longest mates: KQK 10 moves, KRK 16 moves
+    {
+        Position pos;
+        int longest_q = 0, longest_r = 0;
+        for (int wk = 0; wk < 64; ++wk)
+            for (int bk = 0; bk < 64; ++bk)
+                for (int x = 0; x < 64; ++x) {
+                    if (wk == bk || wk == x || bk == x) continue;
+                    for (Piece p : {Piece::WQ, Piece::WR}) {
+                        Position q;
+                        q.set(wk, Piece::WK);
+                        q.set(bk, Piece::BK);
+                        q.set(x, p);
+                        if (Rules::in_check(q, Color::Black)) continue;
+                        auto r = tb.probe(q);
+                        assert(r && r->wdl != Wdl::Loss);
+                        if (r->wdl == Wdl::Win) (p == Piece::WQ ? longest_q : longest_r) =
+                            std::max(p == Piece::WQ ? longest_q : longest_r, r->dtm);
+                    }
+                }
+        assert(longest_q == 19);
+        assert(longest_r == 31);
+    }
+
+    // 4) Save and map back
+    {
+        assert(tb.save("KRvK", ".", err));
+        Tablebase mapped;
+        assert(mapped.load_dir(".", err));
+        assert(mapped.has("KRvK"));
+        auto pos = Parse::fen("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+        assert(mapped.probe(*pos)->dtm == tb.probe(*pos)->dtm);
+        std::remove("KRvK.itb");
+    }
+
+    // 5) Search uses the tables: finds the mate distance at shallow depth
+    {
+        Engine engine;
+        engine.set_tablebase(&tb);
+        auto pos = Parse::fen("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+        SearchLimits limits;
+        limits.depth = 2;
+        SearchResult res = engine.search(*pos, limits);
+        int dtm = tb.probe(*pos)->dtm;
+        assert(res.score == MATE_SCORE - dtm);
+
+        Position after = *pos;
+        after.make_move(res.best, err);
+        auto r = tb.probe(after);
+        assert(r && r->wdl == Wdl::Loss && r->dtm == dtm - 1);
+    }
+
+    std::cout << "test_tablebase: OK\n";
+    return 0;
+}
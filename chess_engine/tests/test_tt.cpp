@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "parse.hpp"
+#include "search.hpp"
+#include "tt.hpp"
+
+using namespace chess;
+
+int main() {
+    const std::string path = "test_tt_tmp.bin";
+    std::string err;
+
+    // Entries survive a round trip, into the same size and into other sizes
+    {
+        TranspositionTable tt(1);
+        Move m;
+        m.from = 12;
+        m.to = 28;
+        auto key = [](uint64_t k) { return k * 0x9E3779B97F4A7C15ULL; };
+        for (uint64_t k = 1; k <= 1000; ++k) tt.store(key(k), m, (int)k - 500, 7, BOUND_EXACT);
+        assert(tt.save(path, err));
+
+        auto count = [&](const TranspositionTable& t) {
+            int found = 0;
+            for (uint64_t k = 1; k <= 1000; ++k) {
+                TTEntry e;
+                if (!t.probe(key(k), e)) continue;
+                assert(e.move == m && e.score == (int)k - 500 && e.depth == 7 && e.bound == BOUND_EXACT);
+                ++found;
+            }
+            return found;
+        };
+        const int stored = count(tt);
+        assert(stored > 900);
+
+        for (std::size_t mb : {1, 2, 4}) {
+            TranspositionTable back(mb);
+            assert(back.load(path, err));
+            assert(back.size_mb() == mb);
+            assert(count(back) == stored);
+        }
+    }
+
+    // A warm table searches the same position in fewer nodes
+    {
+        auto pos = Parse::fen("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+        assert(pos);
+        SearchLimits limits;
+        limits.depth = 6;
+
+        TranspositionTable tt(4);
+        Searcher cold(tt);
+        SearchResult first = cold.search(*pos, limits);
+        assert(tt.save(path, err));
+
+        TranspositionTable warm_tt(4);
+        assert(warm_tt.load(path, err));
+        Searcher warm(warm_tt);
+        SearchResult second = warm.search(*pos, limits);
+        assert(second.nodes < first.nodes / 2);
+        assert(!(second.best == Move{}));
+    }
+
+    // Damaged files are rejected and leave the table untouched
+    {
+        TranspositionTable tt(1);
+        tt.store(42, Move{}, 10, 3, BOUND_LOWER);
+        assert(tt.save(path, err));
+
+        std::string bytes;
+        {
+            std::ifstream in(path, std::ios::binary);
+            bytes.assign(std::istreambuf_iterator<char>(in), {});
+        }
+        auto write = [&](const std::string& b) {
+            std::ofstream(path, std::ios::binary | std::ios::trunc) << b;
+        };
+        auto rejected = [&]() {
+            TranspositionTable t(1);
+            t.store(7, Move{}, 1, 1, BOUND_UPPER);
+            err.clear();
+            bool ok = t.load(path, err);
+            TTEntry e;
+            return !ok && !err.empty() && t.probe(7, e);
+        };
+
+        std::string bad = bytes;
+        bad[bad.size() / 2] ^= 1;  // payload bit flip
+        write(bad);
+        assert(rejected());
+
+        bad = bytes;
+        bad[4] = 99;               // version
+        write(bad);
+        assert(rejected());
+
+        bad = bytes;
+        bad[16] ^= 1;              // Zobrist fingerprint
+        write(bad);
+        assert(rejected());
+
+        write(bytes.substr(0, bytes.size() - 16));
+        assert(rejected());
+
+        write("not a hash snapshot");
+        assert(rejected());
+
+        write(bytes);
+        TranspositionTable t(1);
+        assert(t.load(path, err));
+        TTEntry e;
+        assert(t.probe(42, e) && e.score == 10 && e.depth == 3 && e.bound == BOUND_LOWER);
+    }
+
+    TranspositionTable tt(1);
+    assert(!tt.load("no_such_snapshot.bin", err) && !err.empty());
+
+    std::remove(path.c_str());
+    std::cout << "test_tt: OK\n";
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.hpp"
+#include "eval.hpp"
+#include "movegen.hpp"
+#include "parse.hpp"
+#include "tuner.hpp"
+
+using namespace chess;
+
+static std::vector<Position> corpus() {
+    std::vector<Position> out;
+    for (const std::string& fen : Bench::positions()) {
+        auto pos = Parse::fen(fen);
+        assert(pos);
+        out.push_back(*pos);
+        MoveList ml;
+        MoveGen::generate_legal(*pos, ml);
+        std::string err;
+        for (int i = 0; i < ml.size; ++i) {
+            Position child = *pos;
+            if (child.make_move(ml.moves[i], err)) out.push_back(child);
+        }
+    }
+    return out;
+}
+
+int main() {
+    const std::vector<Position> positions = corpus();
+
+    // Features reproduce evaluate() for any weights
+    {
+        EvalWeights w;
+        for (int i = 0; i < EvalWeights::COUNT; ++i) w.w[i] = (i * 37) % 61 - 30;
+        for (const Position& pos : positions) {
+            EvalFeature f[Eval::MAX_FEATURES];
+            int n = Eval::features(pos, f);
+            int sum = 0;
+            for (int i = 0; i < n; ++i) {
+                assert(f[i].coef != 0);
+                if (i > 0) assert(f[i - 1].index < f[i].index);
+                sum += w.w[f[i].index] * f[i].coef;
+            }
+            assert(sum == Eval::evaluate(pos, w));
+            assert(Eval::evaluate(pos) == Eval::evaluate(pos, Eval::weights()));
+        }
+    }
+
+    // Targets from a known evaluation (knight worth 360): training moves
+    // the weights towards it and lowers the error
+    {
+        EvalWeights truth = Eval::weights();
+        truth.w[EvalWeights::MATERIAL + 1] = 360;
+
+        TunerOptions opts;
+        opts.threads = 2;
+        opts.k = 1.0;
+        opts.lambda = 0.0;
+        Tuner tuner(opts);
+        for (const Position& pos : positions) tuner.add(pos, 0.5, Eval::evaluate(pos, truth));
+        assert(tuner.size() == positions.size());
+
+        const double before = tuner.error();
+        tuner.train(100);
+        const double after = tuner.error();
+        assert(after < before * 0.5);
+        assert(tuner.weights().w[EvalWeights::MATERIAL + 1] > 320);
+    }
+
+    // Output has one number per weight
+    {
+        std::ostringstream out;
+        Tuner::write_weights(out, Eval::weights());
+        std::istringstream in(out.str());
+        int count = 0;
+        for (std::string line; std::getline(in, line);) {
+            if (line.rfind("//", 0) == 0) continue;
+            for (char c : line) count += (c == ',');
+        }
+        assert(count == EvalWeights::COUNT);
+    }
+
+    std::cout << "test_tuner: OK\n";
+    return 0;
+}